@@ -0,0 +1,54 @@
+#ifndef ASSIGNMENTS_DG_BFS_H_
+#define ASSIGNMENTS_DG_BFS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "assignments/dg/csr_graph.h"
+
+namespace gdwg {
+
+// How one level of a breadth first search was expanded
+struct BfsLevel {
+  // Nodes at this depth
+  std::size_t frontier;
+  // Whether the level was expanded bottom-up, from the unvisited nodes' in-edges
+  bool bottom_up;
+  double milliseconds;
+};
+
+struct BfsOptions {
+  // 0 uses one thread per hardware thread
+  std::size_t threads = 0;
+  // Go bottom-up once the frontier's out-edges exceed 1/alpha of the unexplored nodes'
+  // out-edges, and back to top-down once the frontier holds fewer than 1/beta of the nodes
+  double alpha = 15;
+  double beta = 18;
+};
+
+struct BfsResult {
+  static constexpr std::uint32_t unreached = std::numeric_limits<std::uint32_t>::max();
+
+  // Hops from the source for each node id, or unreached
+  std::vector<std::uint32_t> depth;
+  // Parent in the search tree for each node id, or unreached. The source is its own parent.
+  std::vector<std::uint32_t> parent;
+  std::vector<BfsLevel> levels;
+};
+
+// Level-synchronous, direction-optimizing breadth first search from src over a frozen graph.
+// Each level is expanded either top-down from a list of frontier nodes or bottom-up from a
+// bitset of them, whichever is expected to touch fewer edges, and split across threads.
+// Throws std::out_of_range if src is not a node id of g.
+template <typename N, typename E>
+BfsResult BreadthFirstSearch(const CsrGraph<N, E>& g,
+                             typename CsrGraph<N, E>::node_id src,
+                             const BfsOptions& options = {});
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_BFS_H_
+
+#include "assignments/dg/bfs.tpp"
@@ -0,0 +1,145 @@
+#ifndef ASSIGNMENTS_DG_BFS_TPP_
+#define ASSIGNMENTS_DG_BFS_TPP_
+
+#include "assignments/dg/bfs.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+
+#include "assignments/dg/parallel.h"
+
+template <typename N, typename E>
+gdwg::BfsResult gdwg::BreadthFirstSearch(const CsrGraph<N, E>& g,
+                                         typename CsrGraph<N, E>::node_id src,
+                                         const BfsOptions& options) {
+  using node_id = typename CsrGraph<N, E>::node_id;
+  constexpr auto unreached = BfsResult::unreached;
+
+  const std::size_t n = g.NodeCount();
+  if (src >= n) {
+    throw std::out_of_range(
+        "Cannot call gdwg::BreadthFirstSearch if src isn't a node of the graph");
+  }
+  const std::size_t threads = options.threads == 0 ? DefaultThreads() : options.threads;
+  const auto& offsets = g.Offsets();
+  const auto& targets = g.Targets();
+  const auto& in_offsets = g.InOffsets();
+  const auto& sources = g.Sources();
+
+  // A node is visited once it has a parent. Top-down threads race to claim a node with a
+  // compare and swap; bottom-up each node is only ever written by the thread that owns it.
+  BfsResult result;
+  result.depth.assign(n, unreached);
+  std::vector<std::atomic<node_id>> parent(n);
+  ParallelFor(threads, n, [&parent](std::size_t begin, std::size_t end, std::size_t) {
+    for (auto v = begin; v < end; ++v) {
+      parent[v].store(unreached, std::memory_order_relaxed);
+    }
+  });
+  parent[src].store(src, std::memory_order_relaxed);
+  result.depth[src] = 0;
+
+  const std::size_t words = (n + 63) / 64;
+  std::vector<node_id> frontier{src};
+  std::vector<std::uint64_t> frontier_bits;
+  std::vector<std::uint64_t> next_bits;
+  std::size_t frontier_size = 1;
+  std::size_t frontier_edges = g.OutDegree(src);
+  std::size_t unexplored_edges = g.EdgeCount() - frontier_edges;
+  bool bottom_up = false;
+
+  for (std::uint32_t depth = 0; frontier_size > 0; ++depth) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Pick a direction, converting the frontier when it changes
+    if (!bottom_up && frontier_edges > unexplored_edges / options.alpha) {
+      bottom_up = true;
+      frontier_bits.assign(words, 0);
+      for (auto u : frontier) {
+        frontier_bits[u / 64] |= std::uint64_t{1} << (u % 64);
+      }
+    } else if (bottom_up && frontier_size < n / options.beta) {
+      bottom_up = false;
+      frontier.clear();
+      for (std::size_t w = 0; w < words; ++w) {
+        for (auto bits = frontier_bits[w]; bits != 0; bits &= bits - 1) {
+          frontier.push_back(static_cast<node_id>(w * 64 + __builtin_ctzll(bits)));
+        }
+      }
+    }
+
+    // Per thread counts of the nodes found and their out-edges
+    std::vector<std::size_t> found(threads, 0);
+    std::vector<std::size_t> found_edges(threads, 0);
+    if (bottom_up) {
+      // Every unvisited node looks for a parent in the frontier. Threads own whole words of
+      // the next frontier, so they never write to the same word.
+      next_bits.assign(words, 0);
+      ParallelFor(threads, words, [&](std::size_t begin, std::size_t end, std::size_t t) {
+        for (auto w = begin; w < end; ++w) {
+          std::uint64_t bits = 0;
+          for (auto v = w * 64; v < std::min(n, w * 64 + 64); ++v) {
+            if (parent[v].load(std::memory_order_relaxed) != unreached) {
+              continue;
+            }
+            for (auto i = in_offsets[v]; i < in_offsets[v + 1]; ++i) {
+              auto u = sources[i];
+              if ((frontier_bits[u / 64] >> (u % 64)) & 1) {
+                parent[v].store(u, std::memory_order_relaxed);
+                result.depth[v] = depth + 1;
+                bits |= std::uint64_t{1} << (v % 64);
+                ++found[t];
+                found_edges[t] += offsets[v + 1] - offsets[v];
+                break;
+              }
+            }
+          }
+          next_bits[w] = bits;
+        }
+      });
+      frontier_bits.swap(next_bits);
+    } else {
+      // Every frontier node claims its unvisited successors
+      std::vector<std::vector<node_id>> next(threads);
+      ParallelFor(threads, frontier.size(), [&](std::size_t begin, std::size_t end, std::size_t t) {
+        for (auto i = begin; i < end; ++i) {
+          auto u = frontier[i];
+          for (auto j = offsets[u]; j < offsets[u + 1]; ++j) {
+            auto v = targets[j];
+            auto expected = unreached;
+            if (parent[v].load(std::memory_order_relaxed) == unreached &&
+                parent[v].compare_exchange_strong(expected, u, std::memory_order_relaxed)) {
+              result.depth[v] = depth + 1;
+              next[t].push_back(v);
+              ++found[t];
+              found_edges[t] += offsets[v + 1] - offsets[v];
+            }
+          }
+        }
+      });
+      frontier.clear();
+      for (const auto& part : next) {
+        frontier.insert(frontier.end(), part.begin(), part.end());
+      }
+    }
+
+    auto stop = std::chrono::steady_clock::now();
+    result.levels.push_back(
+        {frontier_size, bottom_up, std::chrono::duration<double, std::milli>(stop - start).count()});
+
+    frontier_size = std::accumulate(found.begin(), found.end(), std::size_t{0});
+    frontier_edges = std::accumulate(found_edges.begin(), found_edges.end(), std::size_t{0});
+    unexplored_edges -= frontier_edges;
+  }
+
+  result.parent.resize(n);
+  for (std::size_t v = 0; v < n; ++v) {
+    result.parent[v] = parent[v].load(std::memory_order_relaxed);
+  }
+  return result;
+}
+
+#endif
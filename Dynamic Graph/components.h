@@ -0,0 +1,52 @@
+#ifndef ASSIGNMENTS_DG_COMPONENTS_H_
+#define ASSIGNMENTS_DG_COMPONENTS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "assignments/dg/csr_graph.h"
+#include "assignments/dg/graph.h"
+
+namespace gdwg {
+
+struct ComponentOptions {
+  // 0 uses one thread per hardware thread
+  std::size_t threads = 0;
+};
+
+struct Components {
+  // Component of each node id. Components are numbered from 0 in order of their smallest node
+  // id, so node 0 is always in component 0.
+  std::vector<std::uint32_t> component;
+  std::size_t count = 0;
+};
+
+// Weakly connected components: nodes joined by edges in either direction.
+// Threads take a range of source nodes each and merge the ends of every edge in a shared
+// union-find. Sets are joined by a compare and swap on a root's parent, always hanging the
+// larger root under the smaller, and finds halve paths as they go, so no locks are taken.
+template <typename N, typename E>
+Components WeaklyConnectedComponents(const CsrGraph<N, E>& g, const ComponentOptions& options = {});
+
+// Strongly connected components: nodes that can reach each other.
+// Tarjan's algorithm, run with an explicit stack so deep graphs can't overflow the call stack.
+// It is sequential and linear in nodes plus edges.
+template <typename N, typename E>
+Components StronglyConnectedComponents(const CsrGraph<N, E>& g);
+
+// The same over a Graph, which is frozen first. Node ids are positions in GetNodes() order.
+template <typename N, typename E>
+Components WeaklyConnectedComponents(const Graph<N, E>& g, const ComponentOptions& options = {}) {
+  return WeaklyConnectedComponents(g.Freeze(), options);
+}
+template <typename N, typename E>
+Components StronglyConnectedComponents(const Graph<N, E>& g) {
+  return StronglyConnectedComponents(g.Freeze());
+}
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_COMPONENTS_H_
+
+#include "assignments/dg/components.tpp"
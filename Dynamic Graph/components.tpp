@@ -0,0 +1,167 @@
+#ifndef ASSIGNMENTS_DG_COMPONENTS_TPP_
+#define ASSIGNMENTS_DG_COMPONENTS_TPP_
+
+#include "assignments/dg/components.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <utility>
+
+#include "assignments/dg/parallel.h"
+
+namespace gdwg {
+namespace detail {
+
+// Union-find whose parents only ever point at smaller ids, so the root of a set is its
+// smallest member. Safe to use from many threads at once.
+class ConcurrentUnionFind {
+ public:
+  explicit ConcurrentUnionFind(std::size_t n) : parent_(n) {}
+
+  std::atomic<std::uint32_t>& operator[](std::size_t v) { return parent_[v]; }
+
+  std::uint32_t Find(std::uint32_t v) {
+    while (true) {
+      auto p = parent_[v].load(std::memory_order_relaxed);
+      if (p == v) {
+        return v;
+      }
+      // Point v at its grandparent. Losing the race is harmless: someone else shortened it.
+      auto grandparent = parent_[p].load(std::memory_order_relaxed);
+      if (grandparent != p) {
+        parent_[v].compare_exchange_weak(p, grandparent, std::memory_order_relaxed);
+      }
+      v = grandparent;
+    }
+  }
+
+  void Unite(std::uint32_t u, std::uint32_t v) {
+    while (true) {
+      u = Find(u);
+      v = Find(v);
+      if (u == v) {
+        return;
+      }
+      if (u < v) {
+        std::swap(u, v);
+      }
+      // u is the larger root. If it's no longer a root, find both again.
+      auto expected = u;
+      if (parent_[u].compare_exchange_strong(expected, v, std::memory_order_relaxed)) {
+        return;
+      }
+    }
+  }
+
+ private:
+  std::vector<std::atomic<std::uint32_t>> parent_;
+};
+
+// Numbers the groups of a labelling in order of their smallest member. root[v] must be the
+// smallest member of v's group.
+inline Components NumberByRoot(const std::vector<std::uint32_t>& root) {
+  Components result;
+  result.component.resize(root.size());
+  for (std::size_t v = 0; v < root.size(); ++v) {
+    result.component[v] = root[v] == v ? static_cast<std::uint32_t>(result.count++)
+                                       : result.component[root[v]];
+  }
+  return result;
+}
+
+}  // namespace detail
+}  // namespace gdwg
+
+template <typename N, typename E>
+gdwg::Components gdwg::WeaklyConnectedComponents(const CsrGraph<N, E>& g,
+                                                 const ComponentOptions& options) {
+  const std::size_t n = g.NodeCount();
+  const std::size_t threads = options.threads == 0 ? DefaultThreads() : options.threads;
+  const auto& offsets = g.Offsets();
+  const auto& targets = g.Targets();
+
+  detail::ConcurrentUnionFind sets{n};
+  ParallelFor(threads, n, [&sets](std::size_t begin, std::size_t end, std::size_t) {
+    for (auto v = begin; v < end; ++v) {
+      sets[v].store(static_cast<std::uint32_t>(v), std::memory_order_relaxed);
+    }
+  });
+  ParallelFor(threads, n, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (auto v = begin; v < end; ++v) {
+      for (auto i = offsets[v]; i < offsets[v + 1]; ++i) {
+        sets.Unite(static_cast<std::uint32_t>(v), targets[i]);
+      }
+    }
+  });
+
+  // Joining the threads ordered every link before these finds
+  std::vector<std::uint32_t> root(n);
+  ParallelFor(threads, n, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (auto v = begin; v < end; ++v) {
+      root[v] = sets.Find(static_cast<std::uint32_t>(v));
+    }
+  });
+  return detail::NumberByRoot(root);
+}
+
+template <typename N, typename E>
+gdwg::Components gdwg::StronglyConnectedComponents(const CsrGraph<N, E>& g) {
+  constexpr auto unvisited = std::numeric_limits<std::uint32_t>::max();
+  const std::size_t n = g.NodeCount();
+  const auto& offsets = g.Offsets();
+  const auto& targets = g.Targets();
+
+  // index is the order nodes were reached in and low the smallest index reachable through the
+  // search tree below a node plus one more edge. root ends up as each component's smallest id.
+  std::vector<std::uint32_t> index(n, unvisited);
+  std::vector<std::uint32_t> low(n);
+  std::vector<std::uint32_t> root(n, unvisited);
+  std::vector<std::uint32_t> stack;
+  // Nodes being searched and the next of their edges to follow
+  std::vector<std::pair<std::uint32_t, std::size_t>> calls;
+  std::uint32_t reached = 0;
+
+  for (std::uint32_t start = 0; start < n; ++start) {
+    if (index[start] != unvisited) {
+      continue;
+    }
+    index[start] = low[start] = reached++;
+    stack.push_back(start);
+    calls.emplace_back(start, offsets[start]);
+    while (!calls.empty()) {
+      auto& [v, edge] = calls.back();
+      if (edge < offsets[v + 1]) {
+        auto w = targets[edge++];
+        if (index[w] == unvisited) {
+          index[w] = low[w] = reached++;
+          stack.push_back(w);
+          calls.emplace_back(w, offsets[w]);
+        } else if (root[w] == unvisited) {
+          // w is still on the stack, so it is in v's component or an ancestor's
+          low[v] = std::min(low[v], index[w]);
+        }
+        continue;
+      }
+
+      auto finished = v;
+      calls.pop_back();
+      if (!calls.empty()) {
+        auto parent = calls.back().first;
+        low[parent] = std::min(low[parent], low[finished]);
+      }
+      if (low[finished] == index[finished]) {
+        // finished heads a component: everything above it on the stack
+        auto first = std::find(stack.rbegin(), stack.rend(), finished).base() - 1;
+        auto smallest = *std::min_element(first, stack.end());
+        for (auto it = first; it != stack.end(); ++it) {
+          root[*it] = smallest;
+        }
+        stack.erase(first, stack.end());
+      }
+    }
+  }
+  return detail::NumberByRoot(root);
+}
+
+#endif
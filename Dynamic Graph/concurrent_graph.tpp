@@ -0,0 +1,94 @@
+#ifndef ASSIGNMENTS_DG_CONCURRENT_GRAPH_TPP_
+#define ASSIGNMENTS_DG_CONCURRENT_GRAPH_TPP_
+
+#include "assignments/dg/concurrent_graph.h"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+// Begin constructors
+template <typename N, typename E>
+gdwg::ConcurrentGraph<N, E>::ConcurrentGraph(Graph<N, E> graph)
+  : graph_{std::move(graph)}, current_{new Snapshot{0, graph_.Freeze()}} {}
+// end constructors
+
+template <typename N, typename E>
+gdwg::ConcurrentGraph<N, E>::~ConcurrentGraph() {
+  delete current_.load(std::memory_order_relaxed);
+}
+
+template <typename N, typename E>
+gdwg::ConcurrentGraph<N, E>::ReadView::~ReadView() {
+  if (slot_ != nullptr) {
+    slot_->store(kIdle, std::memory_order_release);
+  }
+  if (overflow_ != nullptr) {
+    overflow_->fetch_sub(1, std::memory_order_release);
+  }
+}
+
+template <typename N, typename E>
+typename gdwg::ConcurrentGraph<N, E>::ReadView gdwg::ConcurrentGraph<N, E>::Read() const {
+  // Announce the current epoch in a free slot before loading the snapshot. A writer only frees
+  // a snapshot once every announced epoch is newer than the one it was replaced in, and a
+  // snapshot loaded after the announcement can't have been replaced before it.
+  // Each thread starts looking at its own slot, so readers rarely try the same one.
+  auto start = std::hash<std::thread::id>{}(std::this_thread::get_id());
+  for (auto i = start; i < start + kSlots; ++i) {
+    auto& slot = slots_[i % kSlots].epoch;
+    if (slot.load(std::memory_order_relaxed) != kIdle) {
+      continue;
+    }
+    auto idle = kIdle;
+    if (slot.compare_exchange_strong(idle, epoch_.load())) {
+      return ReadView{&slot, nullptr, current_.load()};
+    }
+  }
+  // Every slot is taken, so join the overflow count before loading the snapshot. A writer that
+  // misses the count replaced the snapshot before the load, so this reader sees the new one.
+  overflow_.fetch_add(1);
+  return ReadView{nullptr, &overflow_, current_.load()};
+}
+
+template <typename N, typename E>
+template <typename F>
+std::uint64_t gdwg::ConcurrentGraph<N, E>::Commit(F&& batch) {
+  std::lock_guard<std::mutex> lock{writer_};
+  try {
+    std::forward<F>(batch)(graph_);
+  } catch (...) {
+    graph_ = Graph<N, E>::Thaw(current_.load(std::memory_order_relaxed)->graph);
+    throw;
+  }
+  auto version = current_.load(std::memory_order_relaxed)->version + 1;
+  Publish(version);
+  return version;
+}
+
+template <typename N, typename E>
+void gdwg::ConcurrentGraph<N, E>::Publish(std::uint64_t version) {
+  auto fresh = std::make_unique<const Snapshot>(Snapshot{version, graph_.Freeze()});
+  retired_.reserve(retired_.size() + 1);
+  const Snapshot* old = current_.exchange(fresh.release());
+  // Readers that announced this epoch or an older one may still be using old
+  retired_.emplace_back(epoch_.fetch_add(1), old);
+  Reclaim();
+}
+
+template <typename N, typename E>
+void gdwg::ConcurrentGraph<N, E>::Reclaim() {
+  // An overflow reader may hold any retired snapshot, so they all wait for it
+  if (overflow_.load() != 0) {
+    return;
+  }
+  auto oldest = kIdle;
+  for (const auto& slot : slots_) {
+    oldest = std::min(oldest, slot.epoch.load());
+  }
+  retired_.erase(std::remove_if(retired_.begin(), retired_.end(),
+                                [oldest](const auto& retired) { return retired.first < oldest; }),
+                 retired_.end());
+}
+
+#endif
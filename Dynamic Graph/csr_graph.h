@@ -0,0 +1,132 @@
+#ifndef ASSIGNMENTS_DG_CSR_GRAPH_H_
+#define ASSIGNMENTS_DG_CSR_GRAPH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+namespace gdwg {
+
+// Immutable compressed sparse row copy of a Graph, built by Graph::Freeze().
+// Nodes get dense ids in sorted order. The edges of node i are at positions
+// [offsets[i], offsets[i + 1]) of the target and weight arrays, sorted by (dst, weight),
+// so iterating a CsrGraph visits edges in the same order as Graph::const_iterator.
+// The edges are also indexed by destination, so the sources of the edges into node i are at
+// positions [in_offsets[i], in_offsets[i + 1]) of the source array, in ascending order.
+template <typename N, typename E>
+class CsrGraph {
+ public:
+  using node_id = std::uint32_t;
+  static constexpr node_id npos = std::numeric_limits<node_id>::max();
+
+  // Read-only view over a contiguous run of one of the arrays
+  template <typename T>
+  class span {
+   public:
+    span(const T* data, std::size_t size) : data_{data}, size_{size} {}
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+    const T& operator[](std::size_t i) const { return data_[i]; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+   private:
+    const T* data_;
+    std::size_t size_;
+  };
+
+  // Iterator over every edge, in the same order as Graph::const_iterator
+  class const_iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::tuple<N, N, E>;
+    using reference = std::tuple<const N&, const N&, const E&>;
+    using pointer = void;
+    using difference_type = std::ptrdiff_t;
+
+    reference operator*() const;
+    const_iterator& operator++();
+    const_iterator operator++(int) {
+      auto copy{*this};
+      ++(*this);
+      return copy;
+    }
+    const_iterator& operator--();
+    const_iterator operator--(int) {
+      auto copy{*this};
+      --(*this);
+      return copy;
+    }
+    friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) {
+      return lhs.edge_ == rhs.edge_;
+    }
+    friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+    // Source node of the current edge
+    node_id Source() const { return src_; }
+
+   private:
+    const CsrGraph* graph_;
+    node_id src_;
+    std::size_t edge_;
+
+    friend class CsrGraph;
+
+    const_iterator(const CsrGraph* graph, node_id src, std::size_t edge)
+      : graph_{graph}, src_{src}, edge_{edge} {}
+  };
+
+  // Constructors
+  CsrGraph();
+  CsrGraph(std::vector<N> nodes,
+           std::vector<std::size_t> offsets,
+           std::vector<node_id> targets,
+           std::vector<E> weights);
+
+  // Iterator methods
+  const_iterator begin() const;
+  const_iterator end() const;
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  // Methods
+  std::size_t NodeCount() const { return nodes_.size(); }
+  std::size_t EdgeCount() const { return targets_.size(); }
+  const N& Node(node_id id) const { return nodes_[id]; }
+  node_id Id(const N& val) const;
+  bool IsNode(const N& val) const { return Id(val) != npos; }
+  std::size_t OutDegree(node_id id) const { return offsets_[id + 1] - offsets_[id]; }
+  span<node_id> Targets(node_id id) const;
+  span<E> Weights(node_id id) const;
+  std::size_t InDegree(node_id id) const { return in_offsets_[id + 1] - in_offsets_[id]; }
+  span<node_id> Sources(node_id id) const;
+
+  // Whole arrays, for algorithms that walk the graph by id
+  const std::vector<N>& Nodes() const { return nodes_; }
+  const std::vector<std::size_t>& Offsets() const { return offsets_; }
+  const std::vector<node_id>& Targets() const { return targets_; }
+  const std::vector<E>& Weights() const { return weights_; }
+  const std::vector<std::size_t>& InOffsets() const { return in_offsets_; }
+  const std::vector<node_id>& Sources() const { return sources_; }
+
+ private:
+  std::vector<N> nodes_;
+  std::vector<std::size_t> offsets_;
+  std::vector<node_id> targets_;
+  std::vector<E> weights_;
+  std::vector<std::size_t> in_offsets_;
+  std::vector<node_id> sources_;
+
+  void IndexSources();
+};
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_CSR_GRAPH_H_
+
+#include "assignments/dg/csr_graph.tpp"
@@ -0,0 +1,110 @@
+#ifndef ASSIGNMENTS_DG_CSR_GRAPH_TPP_
+#define ASSIGNMENTS_DG_CSR_GRAPH_TPP_
+
+#include "assignments/dg/csr_graph.h"
+
+#include <algorithm>
+#include <utility>
+
+// Begin constructors
+template <typename N, typename E>
+gdwg::CsrGraph<N, E>::CsrGraph() : offsets_{0}, in_offsets_{0} {}
+
+template <typename N, typename E>
+gdwg::CsrGraph<N, E>::CsrGraph(std::vector<N> nodes,
+                               std::vector<std::size_t> offsets,
+                               std::vector<node_id> targets,
+                               std::vector<E> weights)
+  : nodes_{std::move(nodes)}, offsets_{std::move(offsets)}, targets_{std::move(targets)},
+    weights_{std::move(weights)} {
+  IndexSources();
+}
+// end constructors
+
+template <typename N, typename E>
+void gdwg::CsrGraph<N, E>::IndexSources() {
+  // Counting sort of the edges by destination. Walking sources in order keeps each node's
+  // sources sorted.
+  in_offsets_.assign(nodes_.size() + 1, 0);
+  for (auto dst : targets_) {
+    ++in_offsets_[dst + 1];
+  }
+  for (std::size_t i = 0; i < nodes_.size(); ++i) {
+    in_offsets_[i + 1] += in_offsets_[i];
+  }
+  sources_.resize(targets_.size());
+  std::vector<std::size_t> next(in_offsets_.begin(), in_offsets_.end() - 1);
+  for (node_id src = 0; src < nodes_.size(); ++src) {
+    for (auto i = offsets_[src]; i < offsets_[src + 1]; ++i) {
+      sources_[next[targets_[i]]++] = src;
+    }
+  }
+}
+
+template <typename N, typename E>
+typename gdwg::CsrGraph<N, E>::node_id gdwg::CsrGraph<N, E>::Id(const N& val) const {
+  // Nodes are sorted, so the id of a node is its position
+  auto search = std::lower_bound(nodes_.begin(), nodes_.end(), val);
+  if (search == nodes_.end() || val < *search) {
+    return npos;
+  }
+  return static_cast<node_id>(search - nodes_.begin());
+}
+
+template <typename N, typename E>
+typename gdwg::CsrGraph<N, E>::template span<typename gdwg::CsrGraph<N, E>::node_id>
+gdwg::CsrGraph<N, E>::Targets(node_id id) const {
+  return span<node_id>{targets_.data() + offsets_[id], OutDegree(id)};
+}
+
+template <typename N, typename E>
+typename gdwg::CsrGraph<N, E>::template span<E> gdwg::CsrGraph<N, E>::Weights(node_id id) const {
+  return span<E>{weights_.data() + offsets_[id], OutDegree(id)};
+}
+
+template <typename N, typename E>
+typename gdwg::CsrGraph<N, E>::template span<typename gdwg::CsrGraph<N, E>::node_id>
+gdwg::CsrGraph<N, E>::Sources(node_id id) const {
+  return span<node_id>{sources_.data() + in_offsets_[id], InDegree(id)};
+}
+
+template <typename N, typename E>
+typename gdwg::CsrGraph<N, E>::const_iterator gdwg::CsrGraph<N, E>::begin() const {
+  // Skip nodes without edges so the iterator always points at a real edge
+  node_id src = 0;
+  while (src < nodes_.size() && offsets_[src + 1] == 0) {
+    ++src;
+  }
+  return const_iterator{this, src, 0};
+}
+
+template <typename N, typename E>
+typename gdwg::CsrGraph<N, E>::const_iterator gdwg::CsrGraph<N, E>::end() const {
+  return const_iterator{this, static_cast<node_id>(nodes_.size()), targets_.size()};
+}
+
+template <typename N, typename E>
+typename gdwg::CsrGraph<N, E>::const_iterator::reference gdwg::CsrGraph<N, E>::const_iterator::
+operator*() const {
+  return {graph_->nodes_[src_], graph_->nodes_[graph_->targets_[edge_]], graph_->weights_[edge_]};
+}
+
+template <typename N, typename E>
+typename gdwg::CsrGraph<N, E>::const_iterator& gdwg::CsrGraph<N, E>::const_iterator::operator++() {
+  ++edge_;
+  while (src_ < graph_->nodes_.size() && graph_->offsets_[src_ + 1] <= edge_) {
+    ++src_;
+  }
+  return *this;
+}
+
+template <typename N, typename E>
+typename gdwg::CsrGraph<N, E>::const_iterator& gdwg::CsrGraph<N, E>::const_iterator::operator--() {
+  --edge_;
+  while (graph_->offsets_[src_] > edge_) {
+    --src_;
+  }
+  return *this;
+}
+
+#endif
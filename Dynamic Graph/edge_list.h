@@ -0,0 +1,49 @@
+#ifndef ASSIGNMENTS_DG_EDGE_LIST_H_
+#define ASSIGNMENTS_DG_EDGE_LIST_H_
+
+#include <cstddef>
+#include <istream>
+#include <string>
+
+#include "assignments/dg/graph.h"
+
+namespace gdwg {
+
+struct EdgeListOptions {
+  // 0 uses one thread per hardware thread
+  std::size_t threads = 0;
+  // Bytes of text read and parsed at a time. A chunk grows if one line doesn't fit in it.
+  std::size_t chunk_bytes = std::size_t{16} << 20;
+};
+
+struct EdgeListStats {
+  std::size_t bytes = 0;
+  std::size_t lines = 0;
+  // Distinct nodes and edges in the graph built
+  std::size_t nodes = 0;
+  std::size_t edges = 0;
+  // Time spent reading and parsing, and in total including building the graph
+  double parse_seconds = 0;
+  double seconds = 0;
+
+  double MegabytesPerSecond() const { return seconds > 0 ? bytes / 1e6 / seconds : 0; }
+};
+
+// Reads a text edge list of "src dst weight" lines, separated by spaces or tabs, into a graph.
+// Blank lines and lines starting with '#' are skipped.
+// The text is read one chunk at a time. Each chunk is split at line boundaries between worker
+// threads, which parse weights with std::from_chars and intern the node names. Only the
+// distinct names and one compact (src, dst, weight) record per edge are kept between chunks.
+// At the end the records are sorted in per-thread runs, merged, and built into the graph in
+// a single pass through Graph::Thaw.
+// Throws std::runtime_error naming the line if a line can't be parsed.
+template <typename E>
+Graph<std::string, E> LoadEdgeList(std::istream& in,
+                                   const EdgeListOptions& options = {},
+                                   EdgeListStats* stats = nullptr);
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_EDGE_LIST_H_
+
+#include "assignments/dg/edge_list.tpp"
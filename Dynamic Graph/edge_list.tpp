@@ -0,0 +1,350 @@
+#ifndef ASSIGNMENTS_DG_EDGE_LIST_TPP_
+#define ASSIGNMENTS_DG_EDGE_LIST_TPP_
+
+#include "assignments/dg/edge_list.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/csr_graph.h"
+#include "assignments/dg/parallel.h"
+
+namespace gdwg {
+namespace detail {
+
+template <typename E>
+struct EdgeRecord {
+  std::uint32_t src;
+  std::uint32_t dst;
+  E weight;
+
+  friend bool operator<(const EdgeRecord& lhs, const EdgeRecord& rhs) {
+    return std::tie(lhs.src, lhs.dst, lhs.weight) < std::tie(rhs.src, rhs.dst, rhs.weight);
+  }
+  friend bool operator==(const EdgeRecord& lhs, const EdgeRecord& rhs) {
+    return lhs.src == rhs.src && lhs.dst == rhs.dst && lhs.weight == rhs.weight;
+  }
+};
+
+// Open addressing table from names to dense ids. A lookup touches one slot and the name it
+// holds, which is much cheaper than a node based std::unordered_map.
+class NameTable {
+ public:
+  NameTable() { Rehash(1024); }
+
+  // Id of name, and whether it was added. A new name's view is kept, so it must stay valid.
+  std::pair<std::uint32_t, bool> Intern(std::string_view name) {
+    // 0 marks an empty slot
+    auto hash = std::hash<std::string_view>{}(name) | 1;
+    for (auto i = hash & mask_;; i = (i + 1) & mask_) {
+      if (hashes_[i] == 0) {
+        auto id = static_cast<std::uint32_t>(names_.size());
+        hashes_[i] = hash;
+        ids_[i] = id;
+        names_.push_back(name);
+        if (names_.size() * 2 > mask_) {
+          Rehash((mask_ + 1) * 2);
+        }
+        return {id, true};
+      }
+      if (hashes_[i] == hash && names_[ids_[i]] == name) {
+        return {ids_[i], false};
+      }
+    }
+  }
+
+  // Points an id at another copy of its name
+  void Rebind(std::uint32_t id, std::string_view name) { names_[id] = name; }
+
+  const std::vector<std::string_view>& Names() const { return names_; }
+
+  void Clear() {
+    std::fill(hashes_.begin(), hashes_.end(), 0);
+    names_.clear();
+  }
+
+ private:
+  std::vector<std::size_t> hashes_;
+  std::vector<std::uint32_t> ids_;
+  std::vector<std::string_view> names_;
+  std::size_t mask_ = 0;
+
+  void Rehash(std::size_t slots) {
+    auto hashes = std::exchange(hashes_, std::vector<std::size_t>(slots, 0));
+    auto ids = std::exchange(ids_, std::vector<std::uint32_t>(slots, 0));
+    mask_ = slots - 1;
+    for (std::size_t j = 0; j < hashes.size(); ++j) {
+      if (hashes[j] != 0) {
+        auto i = hashes[j] & mask_;
+        while (hashes_[i] != 0) {
+          i = (i + 1) & mask_;
+        }
+        hashes_[i] = hashes[j];
+        ids_[i] = ids[j];
+      }
+    }
+  }
+};
+
+// What one worker parsed from its part of a chunk. Names are views into the chunk and ids are
+// local to the slice until the chunk is merged.
+template <typename E>
+struct ParsedSlice {
+  NameTable names;
+  std::vector<EdgeRecord<E>> edges;
+  std::size_t lines = 0;
+  // Line of the slice that couldn't be parsed, counting from 1, or 0
+  std::size_t bad_line = 0;
+
+  void Reset() {
+    names.Clear();
+    edges.clear();
+    lines = 0;
+    bad_line = 0;
+  }
+};
+
+inline const char* SkipBlanks(const char* p, const char* end) {
+  while (p < end && (*p == ' ' || *p == '\t')) {
+    ++p;
+  }
+  return p;
+}
+
+inline const char* SkipWord(const char* p, const char* end) {
+  while (p < end && *p != ' ' && *p != '\t') {
+    ++p;
+  }
+  return p;
+}
+
+// Parses the complete lines in [begin, end), stopping at the first malformed one
+template <typename E>
+void ParseSlice(const char* begin, const char* end, ParsedSlice<E>& out) {
+  while (begin < end) {
+    auto eol = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+    if (eol == nullptr) {
+      eol = end;
+    }
+    auto line_end = eol;
+    if (line_end > begin && line_end[-1] == '\r') {
+      --line_end;
+    }
+    ++out.lines;
+
+    auto p = SkipBlanks(begin, line_end);
+    if (p != line_end && *p != '#') {
+      auto src_end = SkipWord(p, line_end);
+      std::string_view src{p, static_cast<std::size_t>(src_end - p)};
+      p = SkipBlanks(src_end, line_end);
+      auto dst_end = SkipWord(p, line_end);
+      std::string_view dst{p, static_cast<std::size_t>(dst_end - p)};
+      p = SkipBlanks(dst_end, line_end);
+      E weight{};
+      auto [weight_end, error] = std::from_chars(p, line_end, weight);
+      if (src.empty() || dst.empty() || error != std::errc{} ||
+          SkipBlanks(weight_end, line_end) != line_end) {
+        out.bad_line = out.lines;
+        return;
+      }
+      out.edges.push_back({out.names.Intern(src).first, out.names.Intern(dst).first, weight});
+    }
+    begin = eol + 1;
+  }
+}
+
+}  // namespace detail
+}  // namespace gdwg
+
+template <typename E>
+gdwg::Graph<std::string, E>
+gdwg::LoadEdgeList(std::istream& in, const EdgeListOptions& options, EdgeListStats* stats) {
+  using record = detail::EdgeRecord<E>;
+  using node_id = typename CsrGraph<std::string, E>::node_id;
+
+  auto start = std::chrono::steady_clock::now();
+  const std::size_t threads = options.threads == 0 ? DefaultThreads() : options.threads;
+  EdgeListStats own_stats;
+  auto& st = stats != nullptr ? *stats : own_stats;
+  st = EdgeListStats{};
+
+  // Every name is stored once. The views in ids point into names, and a deque never moves
+  // its elements.
+  std::deque<std::string> names;
+  detail::NameTable ids;
+  std::vector<record> edges;
+
+  std::vector<char> buffer(std::max<std::size_t>(options.chunk_bytes, 1));
+  std::vector<detail::ParsedSlice<E>> slices(threads);
+  std::vector<std::vector<node_id>> slice_ids(threads);
+  std::vector<std::size_t> bounds(threads + 1);
+  std::vector<std::size_t> firsts(threads + 1);
+  // Bytes of an unfinished line carried over from the previous chunk
+  std::size_t carry = 0;
+  for (bool more = true; more;) {
+    in.read(buffer.data() + carry, static_cast<std::streamsize>(buffer.size() - carry));
+    if (in.bad()) {
+      throw std::runtime_error("Cannot call gdwg::LoadEdgeList if the stream can't be read");
+    }
+    auto read = static_cast<std::size_t>(in.gcount());
+    st.bytes += read;
+    more = static_cast<bool>(in);
+    std::size_t size = carry + read;
+
+    // Parse up to the end of the last complete line, or everything at the end of the input
+    std::size_t parse = size;
+    if (more) {
+      auto last = std::find(buffer.rbegin() + static_cast<std::ptrdiff_t>(buffer.size() - size),
+                            buffer.rend(), '\n');
+      if (last == buffer.rend()) {
+        // A line longer than the chunk
+        carry = size;
+        buffer.resize(buffer.size() * 2);
+        continue;
+      }
+      parse = static_cast<std::size_t>(buffer.rend() - last);
+    }
+
+    // Give each thread a run of whole lines
+    bounds[0] = 0;
+    bounds[threads] = parse;
+    for (std::size_t t = 1; t < threads; ++t) {
+      auto p = std::max(bounds[t - 1], parse * t / threads);
+      while (p > 0 && p < parse && buffer[p - 1] != '\n') {
+        ++p;
+      }
+      bounds[t] = p;
+    }
+    ParallelFor(threads, threads, [&](std::size_t begin, std::size_t end, std::size_t) {
+      for (auto t = begin; t < end; ++t) {
+        slices[t].Reset();
+        detail::ParseSlice(buffer.data() + bounds[t], buffer.data() + bounds[t + 1], slices[t]);
+      }
+    });
+
+    // Merge the names each thread found into the global table
+    for (std::size_t t = 0; t < threads; ++t) {
+      const auto& slice = slices[t];
+      if (slice.bad_line != 0) {
+        throw std::runtime_error("Cannot call gdwg::LoadEdgeList on input with a malformed line " +
+                                 std::to_string(st.lines + slice.bad_line));
+      }
+      st.lines += slice.lines;
+      const auto& slice_names = slice.names.Names();
+      slice_ids[t].resize(slice_names.size());
+      for (std::size_t i = 0; i < slice_names.size(); ++i) {
+        auto [id, inserted] = ids.Intern(slice_names[i]);
+        if (inserted) {
+          names.emplace_back(slice_names[i]);
+          ids.Rebind(id, names.back());
+        }
+        slice_ids[t][i] = id;
+      }
+      firsts[t + 1] = firsts[t] + slice.edges.size();
+    }
+
+    // Then translate and append their edges
+    auto base = edges.size();
+    edges.resize(base + firsts[threads]);
+    ParallelFor(threads, threads, [&](std::size_t begin, std::size_t end, std::size_t) {
+      for (auto t = begin; t < end; ++t) {
+        auto out = edges.begin() + static_cast<std::ptrdiff_t>(base + firsts[t]);
+        for (const auto& edge : slices[t].edges) {
+          *out++ = record{slice_ids[t][edge.src], slice_ids[t][edge.dst], edge.weight};
+        }
+      }
+    });
+
+    carry = size - parse;
+    std::copy(buffer.begin() + static_cast<std::ptrdiff_t>(parse),
+              buffer.begin() + static_cast<std::ptrdiff_t>(size), buffer.begin());
+  }
+  slices.clear();
+  buffer = std::vector<char>{};
+  ids = detail::NameTable{};
+  st.parse_seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  // Renumber the nodes in sorted order, which is the order the graph keeps them in
+  std::vector<node_id> order(names.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&names](node_id lhs, node_id rhs) { return names[lhs] < names[rhs]; });
+  std::vector<node_id> rank(names.size());
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    rank[order[i]] = static_cast<node_id>(i);
+  }
+
+  // Each thread renumbers and sorts a run of the edges, then the runs are merged pairwise
+  std::vector<std::size_t> runs(threads + 1);
+  for (std::size_t t = 0; t <= threads; ++t) {
+    runs[t] = edges.size() * t / threads;
+  }
+  ParallelFor(threads, threads, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (auto t = begin; t < end; ++t) {
+      auto first = edges.begin() + static_cast<std::ptrdiff_t>(runs[t]);
+      auto last = edges.begin() + static_cast<std::ptrdiff_t>(runs[t + 1]);
+      for (auto it = first; it != last; ++it) {
+        it->src = rank[it->src];
+        it->dst = rank[it->dst];
+      }
+      std::sort(first, last);
+    }
+  });
+  for (std::size_t width = 1; width < threads; width *= 2) {
+    auto pairs = (threads + 2 * width - 1) / (2 * width);
+    ParallelFor(threads, pairs, [&](std::size_t begin, std::size_t end, std::size_t) {
+      for (auto pair = begin; pair < end; ++pair) {
+        auto left = pair * 2 * width;
+        auto mid = std::min(left + width, threads);
+        auto right = std::min(left + 2 * width, threads);
+        std::inplace_merge(edges.begin() + static_cast<std::ptrdiff_t>(runs[left]),
+                           edges.begin() + static_cast<std::ptrdiff_t>(runs[mid]),
+                           edges.begin() + static_cast<std::ptrdiff_t>(runs[right]));
+      }
+    });
+  }
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+  // Lay the edges out as a frozen graph, which can be built without any searching
+  std::vector<std::string> nodes;
+  nodes.reserve(names.size());
+  for (auto id : order) {
+    nodes.push_back(std::move(names[id]));
+  }
+  names = std::deque<std::string>{};
+  std::vector<std::size_t> offsets(nodes.size() + 1, 0);
+  std::vector<node_id> targets;
+  std::vector<E> weights;
+  targets.reserve(edges.size());
+  weights.reserve(edges.size());
+  for (const auto& edge : edges) {
+    ++offsets[edge.src + 1];
+    targets.push_back(edge.dst);
+    weights.push_back(edge.weight);
+  }
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    offsets[i + 1] += offsets[i];
+  }
+  st.nodes = nodes.size();
+  st.edges = edges.size();
+  edges = std::vector<record>{};
+
+  auto graph = Graph<std::string, E>::Thaw(CsrGraph<std::string, E>{
+      std::move(nodes), std::move(offsets), std::move(targets), std::move(weights)});
+  st.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return graph;
+}
+
+#endif
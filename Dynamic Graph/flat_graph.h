@@ -0,0 +1,210 @@
+#ifndef ASSIGNMENTS_DG_FLAT_GRAPH_H_
+#define ASSIGNMENTS_DG_FLAT_GRAPH_H_
+
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+
+namespace gdwg {
+
+// Whether FlatGraph can hold N and E: both copy as plain bytes, and a node is small enough that
+// a copy of it in every edge costs no more than the reference and edge pointer Graph keeps
+template <typename N, typename E>
+struct IsFlatStorable
+  : std::bool_constant<std::is_trivially_copyable_v<N> && std::is_trivially_copyable_v<E> &&
+                       sizeof(N) <= 16> {};
+
+// A Graph for trivially copyable nodes and weights, stored as arrays rather than behind
+// pointers. The nodes are one sorted array, and each node has parallel arrays of edge targets
+// and weights, sorted by (dst, weight), plus the sources of the edges into it. Edges hold
+// copies of their target, so walking them never leaves the node's arrays.
+// The methods behave like Graph's, printing the same messages for missing nodes.
+// InsertNode, DeleteNode and Replace shift the nodes after the one they change, so they are
+// O(V) where Graph's are O(log V). Build large graphs from an edge range or a Graph instead.
+// Like Graph, iterators are invalidated by any change.
+template <typename N, typename E>
+class FlatGraph {
+  static_assert(IsFlatStorable<N, E>::value, "FlatGraph needs small, trivially copyable N and E");
+
+ public:
+  class const_iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::tuple<N, N, E>;
+    using reference = std::tuple<const N&, const N&, const E&>;
+    struct pointer {
+      reference value;
+      const reference* operator->() const { return &value; }
+    };
+    using difference_type = int;
+
+    reference operator*() const;
+    pointer operator->() const { return pointer{operator*()}; }
+    const_iterator& operator++();
+    const_iterator operator++(int) {
+      auto copy{*this};
+      ++(*this);
+      return copy;
+    }
+    const_iterator& operator--();
+    const_iterator operator--(int) {
+      auto copy{*this};
+      --(*this);
+      return copy;
+    }
+    friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) {
+      return lhs.node_ == rhs.node_ && lhs.edge_ == rhs.edge_;
+    }
+    friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+   private:
+    const FlatGraph* graph_;
+    std::size_t node_;
+    std::size_t edge_;
+
+    friend class FlatGraph;
+
+    const_iterator(const FlatGraph* graph, std::size_t node, std::size_t edge)
+      : graph_{graph}, node_{node}, edge_{edge} {}
+
+    // Moves past nodes without edges left, so the iterator is at an edge or at the end
+    void SkipEmpty();
+  };
+
+  // Iterator methods
+  const_iterator begin() const { return cbegin(); }
+  const_iterator end() const { return cend(); }
+  const_iterator find(const N& src, const N& dst, const E& w) const;
+  const_iterator erase(const_iterator it);
+  const_iterator cbegin() const;
+  const_iterator cend() const { return const_iterator{this, nodes_.size(), 0}; }
+
+  // Reverse iterators
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  const_reverse_iterator rbegin() const { return crbegin(); }
+  const_reverse_iterator rend() const { return crend(); }
+  const_reverse_iterator crbegin() const { return const_reverse_iterator{cend()}; }
+  const_reverse_iterator crend() const { return const_reverse_iterator{cbegin()}; }
+
+  // Constructors
+  FlatGraph() = default;
+  FlatGraph(typename std::vector<N>::const_iterator, typename std::vector<N>::const_iterator);
+  // Sorts and deduplicates the edges in one batch, creating both ends of each
+  FlatGraph(typename std::vector<std::tuple<N, N, E>>::const_iterator,
+            typename std::vector<std::tuple<N, N, E>>::const_iterator);
+  FlatGraph(std::initializer_list<N>);
+  // Graph keeps its nodes and edges sorted in the same order, so they are appended in one pass
+  explicit FlatGraph(const Graph<N, E>& graph);
+
+  // Methods
+  bool InsertNode(const N& val);
+  bool InsertEdge(const N& src, const N& dst, const E& w);
+  bool DeleteNode(const N& val);
+  bool Replace(const N& oldData, const N& newData);
+  void MergeReplace(const N& oldData, const N& newData);
+  void Clear();
+  bool IsNode(const N& val) const { return Find(val) != npos; }
+  bool IsConnected(const N& src, const N& dst);
+  std::vector<N> GetNodes() const { return nodes_; }
+  std::vector<N> GetConnected(const N& src);
+  std::vector<E> GetWeights(const N& src, const N& dst);
+  std::vector<N> GetPredecessors(const N& dst);
+  GraphStatus TryInsertEdge(const N& src, const N& dst, const E& w);
+  GraphStatus TryErase(const N& src, const N& dst, const E& w);
+  GraphStatus TryReplace(const N& oldData, const N& newData);
+  GraphStatus TryMergeReplace(const N& oldData, const N& newData);
+  GraphStatus TryIsConnected(const N& src, const N& dst, bool& connected) const;
+  GraphStatus TryGetConnected(const N& src, std::vector<N>& out) const;
+  GraphStatus TryGetWeights(const N& src, const N& dst, std::vector<E>& out) const;
+  GraphStatus TryGetPredecessors(const N& dst, std::vector<N>& out) const;
+  bool erase(const N& src, const N& dst, const E& w);
+  std::size_t NodeCount() const { return nodes_.size(); }
+  std::size_t EdgeCount() const { return edges_; }
+  Graph<N, E> ToGraph() const;
+
+  // Friends
+  friend std::ostream& operator<<(std::ostream& os, const FlatGraph<N, E>& source) {
+    for (std::size_t i = 0; i < source.nodes_.size(); ++i) {
+      const auto& node = source.adjacency_[i];
+      os << source.nodes_[i] << " (\n";
+      for (std::size_t j = 0; j < node.targets.size(); ++j) {
+        os << "\t" << node.targets[j] << " | " << node.weights[j] << "\n";
+      }
+      os << ")\n";
+    }
+    return os;
+  }
+
+  friend bool operator==(const FlatGraph<N, E>& lhs, const FlatGraph<N, E>& rhs) {
+    if (lhs.edges_ != rhs.edges_ || lhs.nodes_ != rhs.nodes_) {
+      return false;
+    }
+    for (std::size_t i = 0; i < lhs.nodes_.size(); ++i) {
+      if (lhs.adjacency_[i].targets != rhs.adjacency_[i].targets ||
+          lhs.adjacency_[i].weights != rhs.adjacency_[i].weights) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  friend bool operator!=(const FlatGraph<N, E>& lhs, const FlatGraph<N, E>& rhs) {
+    return !(lhs == rhs);
+  }
+
+ private:
+  struct Adjacency {
+    std::vector<N> targets;
+    std::vector<E> weights;
+    // Sources of the edges into the node, one per edge, in ascending order
+    std::vector<N> sources;
+  };
+
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  // nodes_[i] and adjacency_[i] describe the same node
+  std::vector<N> nodes_;
+  std::vector<Adjacency> adjacency_;
+  std::size_t edges_ = 0;
+
+  // Position of the node in nodes_, or npos if it isn't there
+  std::size_t Find(const N& val) const;
+  // Position of the first edge out of node at or after (dst, w)
+  static std::size_t LowerBound(const Adjacency& node, const N& dst, const E& w);
+  // Range of the edges out of node to dst
+  static std::pair<std::size_t, std::size_t> EqualRange(const Adjacency& node, const N& dst);
+  // Inserts the edge between the nodes at src and dst unless it is already there
+  bool Link(std::size_t src, std::size_t dst, const E& w);
+  // Removes the edge at position edge out of the node at src
+  void Unlink(std::size_t src, std::size_t edge);
+  // Removes a node and every edge into or out of it, returning those edges as
+  // (src, dst, weight), each once
+  std::vector<std::tuple<N, N, E>> Detach(std::size_t node);
+  // Sorts and deduplicates nodes_ and gives every node empty edge arrays
+  void SortNodes();
+  static bool Same(const N& lhs, const N& rhs) { return !(lhs < rhs) && !(rhs < lhs); }
+};
+
+// FlatGraph where it can hold N and E, otherwise Graph. Code written against the alias may only
+// use what both have: the constructors, iterators, find and erase, the node and edge methods
+// from InsertNode to GetPredecessors, the Try* methods other than TryApply, and the operators.
+// Apply, TryApply, BulkLoad, Freeze, Thaw, Edges, Fingerprint, Adjacency and Predecessors are
+// Graph's alone, and NodeCount, EdgeCount and ToGraph are FlatGraph's.
+template <typename N, typename E>
+using CompactGraph =
+    std::conditional_t<IsFlatStorable<N, E>::value, FlatGraph<N, E>, Graph<N, E>>;
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_FLAT_GRAPH_H_
+
+#include "assignments/dg/flat_graph.tpp"
@@ -0,0 +1,513 @@
+#ifndef ASSIGNMENTS_DG_FLAT_GRAPH_TPP_
+#define ASSIGNMENTS_DG_FLAT_GRAPH_TPP_
+
+#include "assignments/dg/flat_graph.h"
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+// Begin constructors
+template <typename N, typename E>
+gdwg::FlatGraph<N, E>::FlatGraph(typename std::vector<N>::const_iterator start,
+                                 typename std::vector<N>::const_iterator end)
+  : nodes_(start, end) {
+  SortNodes();
+}
+
+template <typename N, typename E>
+gdwg::FlatGraph<N, E>::FlatGraph(typename std::vector<std::tuple<N, N, E>>::const_iterator start,
+                                 typename std::vector<std::tuple<N, N, E>>::const_iterator end) {
+  std::vector<std::tuple<N, N, E>> edges(start, end);
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end(),
+                          [](const auto& lhs, const auto& rhs) {
+                            return !(lhs < rhs) && !(rhs < lhs);
+                          }),
+              edges.end());
+  nodes_.reserve(2 * edges.size());
+  for (const auto& [src, dst, w] : edges) {
+    nodes_.push_back(src);
+    nodes_.push_back(dst);
+  }
+  SortNodes();
+
+  // The edges are sorted by source, so sources are appended in ascending order and each
+  // node's edges in (dst, weight) order
+  std::size_t src = 0;
+  for (const auto& [from, to, w] : edges) {
+    while (nodes_[src] < from) {
+      ++src;
+    }
+    adjacency_[src].targets.push_back(to);
+    adjacency_[src].weights.push_back(w);
+    adjacency_[Find(to)].sources.push_back(from);
+  }
+  edges_ = edges.size();
+}
+
+template <typename N, typename E>
+gdwg::FlatGraph<N, E>::FlatGraph(std::initializer_list<N> input_list) : nodes_(input_list) {
+  SortNodes();
+}
+
+template <typename N, typename E>
+gdwg::FlatGraph<N, E>::FlatGraph(const Graph<N, E>& graph) {
+  const auto& nodes = graph.Adjacency();
+  nodes_.reserve(nodes.size());
+  adjacency_.resize(nodes.size());
+  std::size_t i = 0;
+  for (const auto& [node, edges] : nodes) {
+    nodes_.push_back(*node);
+    auto& adjacency = adjacency_[i++];
+    adjacency.targets.reserve(edges.size());
+    adjacency.weights.reserve(edges.size());
+    for (const auto& edge : edges) {
+      adjacency.targets.push_back(std::get<0>(*edge));
+      adjacency.weights.push_back(std::get<1>(*edge));
+    }
+    edges_ += edges.size();
+  }
+  // Walking the sources in order appends each node's sources in ascending order
+  for (i = 0; i < nodes_.size(); ++i) {
+    for (const auto& dst : adjacency_[i].targets) {
+      adjacency_[Find(dst)].sources.push_back(nodes_[i]);
+    }
+  }
+}
+// end constructors
+
+template <typename N, typename E>
+bool gdwg::FlatGraph<N, E>::InsertNode(const N& val) {
+  auto search = std::lower_bound(nodes_.begin(), nodes_.end(), val);
+  if (search != nodes_.end() && !(val < *search)) {
+    return false;
+  }
+  adjacency_.emplace(adjacency_.begin() + (search - nodes_.begin()));
+  nodes_.insert(search, val);
+  return true;
+}
+
+template <typename N, typename E>
+bool gdwg::FlatGraph<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
+  auto status = TryInsertEdge(src, dst, w);
+  if (status == GraphStatus::kMissingSrc || status == GraphStatus::kMissingDst) {
+    std::cout << "Cannot call Graph::InsertEdge when either src or dst node does not exist\n";
+  }
+  return status == GraphStatus::kOk;
+}
+
+template <typename N, typename E>
+gdwg::GraphStatus gdwg::FlatGraph<N, E>::TryInsertEdge(const N& src, const N& dst, const E& w) {
+  auto search_src = Find(src);
+  if (search_src == npos) {
+    return GraphStatus::kMissingSrc;
+  }
+  auto search_dst = Find(dst);
+  if (search_dst == npos) {
+    return GraphStatus::kMissingDst;
+  }
+  return Link(search_src, search_dst, w) ? GraphStatus::kOk : GraphStatus::kExists;
+}
+
+template <typename N, typename E>
+bool gdwg::FlatGraph<N, E>::DeleteNode(const N& val) {
+  auto search = Find(val);
+  if (search == npos) {
+    return false;
+  }
+  Detach(search);
+  return true;
+}
+
+template <typename N, typename E>
+bool gdwg::FlatGraph<N, E>::Replace(const N& oldData, const N& newData) {
+  auto status = TryReplace(oldData, newData);
+  if (status == GraphStatus::kMissingSrc) {
+    std::cout << "Cannot call Graph::Replace on a node that doesn't exist\n";
+  }
+  return status == GraphStatus::kOk;
+}
+
+template <typename N, typename E>
+gdwg::GraphStatus gdwg::FlatGraph<N, E>::TryReplace(const N& oldData, const N& newData) {
+  auto search = Find(oldData);
+  if (search == npos) {
+    return GraphStatus::kMissingSrc;
+  }
+  if (Find(newData) != npos) {
+    return GraphStatus::kExists;
+  }
+  // The node moves in the sorted order, so take it out with its edges and put them back
+  // under the new value
+  const N old_value = nodes_[search];
+  auto touching = Detach(search);
+  InsertNode(newData);
+  for (const auto& [src, dst, w] : touching) {
+    Link(Find(Same(src, old_value) ? newData : src), Find(Same(dst, old_value) ? newData : dst),
+         w);
+  }
+  return GraphStatus::kOk;
+}
+
+template <typename N, typename E>
+void gdwg::FlatGraph<N, E>::MergeReplace(const N& oldData, const N& newData) {
+  auto status = TryMergeReplace(oldData, newData);
+  if (status == GraphStatus::kMissingSrc || status == GraphStatus::kMissingDst) {
+    std::cout
+        << "Cannot call Graph::MergeReplace on old or new data if they don't exist in the graph\n";
+  }
+}
+
+template <typename N, typename E>
+gdwg::GraphStatus gdwg::FlatGraph<N, E>::TryMergeReplace(const N& oldData, const N& newData) {
+  auto search_old = Find(oldData);
+  if (search_old == npos) {
+    return GraphStatus::kMissingSrc;
+  }
+  auto search_new = Find(newData);
+  if (search_new == npos) {
+    return GraphStatus::kMissingDst;
+  }
+  if (search_old == search_new) {
+    return GraphStatus::kOk;
+  }
+  // Edges already present on the new node are dropped by Link
+  const N old_value = nodes_[search_old];
+  auto touching = Detach(search_old);
+  for (const auto& [src, dst, w] : touching) {
+    Link(Find(Same(src, old_value) ? newData : src), Find(Same(dst, old_value) ? newData : dst),
+         w);
+  }
+  return GraphStatus::kOk;
+}
+
+template <typename N, typename E>
+void gdwg::FlatGraph<N, E>::Clear() {
+  nodes_.clear();
+  adjacency_.clear();
+  edges_ = 0;
+}
+
+template <typename N, typename E>
+bool gdwg::FlatGraph<N, E>::IsConnected(const N& src, const N& dst) {
+  // A missing node is reported as connected, as Graph does
+  bool connected = true;
+  if (TryIsConnected(src, dst, connected) != GraphStatus::kOk) {
+    std::cout << "Cannot call Graph::IsConnected if src or dst node don't exist in the graph\n";
+  }
+  return connected;
+}
+
+template <typename N, typename E>
+gdwg::GraphStatus
+gdwg::FlatGraph<N, E>::TryIsConnected(const N& src, const N& dst, bool& connected) const {
+  auto search_src = Find(src);
+  if (search_src == npos) {
+    return GraphStatus::kMissingSrc;
+  }
+  if (Find(dst) == npos) {
+    return GraphStatus::kMissingDst;
+  }
+  auto range = EqualRange(adjacency_[search_src], dst);
+  connected = range.first != range.second;
+  return GraphStatus::kOk;
+}
+
+template <typename N, typename E>
+std::vector<N> gdwg::FlatGraph<N, E>::GetConnected(const N& src) {
+  std::vector<N> vec;
+  if (TryGetConnected(src, vec) != GraphStatus::kOk) {
+    std::cout << "Cannot call Graph::GetConnected if src doesn't exist in the graph\n";
+  }
+  return vec;
+}
+
+template <typename N, typename E>
+gdwg::GraphStatus
+gdwg::FlatGraph<N, E>::TryGetConnected(const N& src, std::vector<N>& out) const {
+  auto search_src = Find(src);
+  if (search_src == npos) {
+    return GraphStatus::kMissingSrc;
+  }
+  // One entry per edge, like Graph
+  const auto& targets = adjacency_[search_src].targets;
+  out.assign(targets.begin(), targets.end());
+  return GraphStatus::kOk;
+}
+
+template <typename N, typename E>
+std::vector<E> gdwg::FlatGraph<N, E>::GetWeights(const N& src, const N& dst) {
+  std::vector<E> vec;
+  if (TryGetWeights(src, dst, vec) != GraphStatus::kOk) {
+    std::cout << "Cannot call Graph::GetWeights if src or dst node don't exist in the graph\n";
+  }
+  return vec;
+}
+
+template <typename N, typename E>
+gdwg::GraphStatus
+gdwg::FlatGraph<N, E>::TryGetWeights(const N& src, const N& dst, std::vector<E>& out) const {
+  auto search_src = Find(src);
+  if (search_src == npos) {
+    return GraphStatus::kMissingSrc;
+  }
+  if (Find(dst) == npos) {
+    return GraphStatus::kMissingDst;
+  }
+  const auto& weights = adjacency_[search_src].weights;
+  auto range = EqualRange(adjacency_[search_src], dst);
+  out.assign(weights.begin() + static_cast<std::ptrdiff_t>(range.first),
+             weights.begin() + static_cast<std::ptrdiff_t>(range.second));
+  return GraphStatus::kOk;
+}
+
+template <typename N, typename E>
+std::vector<N> gdwg::FlatGraph<N, E>::GetPredecessors(const N& dst) {
+  std::vector<N> vec;
+  if (TryGetPredecessors(dst, vec) != GraphStatus::kOk) {
+    std::cout << "Cannot call Graph::GetPredecessors if dst doesn't exist in the graph\n";
+  }
+  return vec;
+}
+
+template <typename N, typename E>
+gdwg::GraphStatus
+gdwg::FlatGraph<N, E>::TryGetPredecessors(const N& dst, std::vector<N>& out) const {
+  auto search_dst = Find(dst);
+  if (search_dst == npos) {
+    return GraphStatus::kMissingDst;
+  }
+  // Sources are sorted with one entry per edge, so dropping repeats leaves each predecessor once
+  const auto& sources = adjacency_[search_dst].sources;
+  out.clear();
+  std::unique_copy(sources.begin(), sources.end(), std::back_inserter(out), Same);
+  return GraphStatus::kOk;
+}
+
+template <typename N, typename E>
+bool gdwg::FlatGraph<N, E>::erase(const N& src, const N& dst, const E& w) {
+  return TryErase(src, dst, w) == GraphStatus::kOk;
+}
+
+template <typename N, typename E>
+gdwg::GraphStatus gdwg::FlatGraph<N, E>::TryErase(const N& src, const N& dst, const E& w) {
+  auto search_src = Find(src);
+  if (search_src == npos) {
+    return GraphStatus::kMissingSrc;
+  }
+  const auto& node = adjacency_[search_src];
+  auto position = LowerBound(node, dst, w);
+  if (position == node.targets.size() || dst < node.targets[position] ||
+      w < node.weights[position]) {
+    // Only a failed erase pays for looking up dst
+    return Find(dst) == npos ? GraphStatus::kMissingDst : GraphStatus::kMissingEdge;
+  }
+  Unlink(search_src, position);
+  return GraphStatus::kOk;
+}
+
+template <typename N, typename E>
+gdwg::Graph<N, E> gdwg::FlatGraph<N, E>::ToGraph() const {
+  std::vector<std::tuple<N, N, E>> edges;
+  edges.reserve(edges_);
+  for (std::size_t i = 0; i < nodes_.size(); ++i) {
+    const auto& node = adjacency_[i];
+    for (std::size_t j = 0; j < node.targets.size(); ++j) {
+      edges.emplace_back(nodes_[i], node.targets[j], node.weights[j]);
+    }
+  }
+  auto graph = Graph<N, E>::BulkLoad(edges.begin(), edges.end());
+  for (std::size_t i = 0; i < nodes_.size(); ++i) {
+    if (adjacency_[i].targets.empty()) {
+      graph.InsertNode(nodes_[i]);
+    }
+  }
+  return graph;
+}
+
+template <typename N, typename E>
+typename gdwg::FlatGraph<N, E>::const_iterator
+gdwg::FlatGraph<N, E>::find(const N& src, const N& dst, const E& w) const {
+  auto search_src = Find(src);
+  if (search_src == npos) {
+    return end();
+  }
+  const auto& node = adjacency_[search_src];
+  auto position = LowerBound(node, dst, w);
+  if (position == node.targets.size() || dst < node.targets[position] ||
+      w < node.weights[position]) {
+    return end();
+  }
+  return const_iterator{this, search_src, position};
+}
+
+template <typename N, typename E>
+typename gdwg::FlatGraph<N, E>::const_iterator gdwg::FlatGraph<N, E>::erase(const_iterator it) {
+  if (it == end()) {
+    return end();
+  }
+  // The later edges of the node move down into the erased one's place
+  Unlink(it.node_, it.edge_);
+  it.SkipEmpty();
+  return it;
+}
+
+template <typename N, typename E>
+typename gdwg::FlatGraph<N, E>::const_iterator gdwg::FlatGraph<N, E>::cbegin() const {
+  const_iterator it{this, 0, 0};
+  it.SkipEmpty();
+  return it;
+}
+
+template <typename N, typename E>
+typename gdwg::FlatGraph<N, E>::const_iterator::reference
+gdwg::FlatGraph<N, E>::const_iterator::operator*() const {
+  const auto& node = graph_->adjacency_[node_];
+  return {graph_->nodes_[node_], node.targets[edge_], node.weights[edge_]};
+}
+
+template <typename N, typename E>
+typename gdwg::FlatGraph<N, E>::const_iterator&
+gdwg::FlatGraph<N, E>::const_iterator::operator++() {
+  if (node_ < graph_->nodes_.size()) {
+    ++edge_;
+    SkipEmpty();
+  }
+  return *this;
+}
+
+template <typename N, typename E>
+typename gdwg::FlatGraph<N, E>::const_iterator&
+gdwg::FlatGraph<N, E>::const_iterator::operator--() {
+  if (edge_ > 0) {
+    --edge_;
+    return *this;
+  }
+  // Back to the last edge of the nearest earlier node with any. At the first edge, stay.
+  for (auto node = node_; node > 0; --node) {
+    const auto& targets = graph_->adjacency_[node - 1].targets;
+    if (!targets.empty()) {
+      node_ = node - 1;
+      edge_ = targets.size() - 1;
+      return *this;
+    }
+  }
+  return *this;
+}
+
+template <typename N, typename E>
+void gdwg::FlatGraph<N, E>::const_iterator::SkipEmpty() {
+  const auto& adjacency = graph_->adjacency_;
+  while (node_ < adjacency.size() && edge_ == adjacency[node_].targets.size()) {
+    ++node_;
+    edge_ = 0;
+  }
+}
+
+template <typename N, typename E>
+std::size_t gdwg::FlatGraph<N, E>::Find(const N& val) const {
+  auto search = std::lower_bound(nodes_.begin(), nodes_.end(), val);
+  if (search == nodes_.end() || val < *search) {
+    return npos;
+  }
+  return static_cast<std::size_t>(search - nodes_.begin());
+}
+
+template <typename N, typename E>
+std::size_t gdwg::FlatGraph<N, E>::LowerBound(const Adjacency& node, const N& dst, const E& w) {
+  auto range = EqualRange(node, dst);
+  auto first = node.weights.begin() + static_cast<std::ptrdiff_t>(range.first);
+  auto last = node.weights.begin() + static_cast<std::ptrdiff_t>(range.second);
+  return static_cast<std::size_t>(std::lower_bound(first, last, w) - node.weights.begin());
+}
+
+template <typename N, typename E>
+std::pair<std::size_t, std::size_t> gdwg::FlatGraph<N, E>::EqualRange(const Adjacency& node,
+                                                                      const N& dst) {
+  auto range = std::equal_range(node.targets.begin(), node.targets.end(), dst);
+  return {static_cast<std::size_t>(range.first - node.targets.begin()),
+          static_cast<std::size_t>(range.second - node.targets.begin())};
+}
+
+template <typename N, typename E>
+bool gdwg::FlatGraph<N, E>::Link(std::size_t src, std::size_t dst, const E& w) {
+  auto& node = adjacency_[src];
+  const N& value = nodes_[dst];
+  auto position = LowerBound(node, value, w);
+  if (position < node.targets.size() && !(value < node.targets[position]) &&
+      !(w < node.weights[position])) {
+    return false;
+  }
+  node.targets.insert(node.targets.begin() + static_cast<std::ptrdiff_t>(position), value);
+  node.weights.insert(node.weights.begin() + static_cast<std::ptrdiff_t>(position), w);
+  auto& sources = adjacency_[dst].sources;
+  sources.insert(std::upper_bound(sources.begin(), sources.end(), nodes_[src]), nodes_[src]);
+  ++edges_;
+  return true;
+}
+
+template <typename N, typename E>
+void gdwg::FlatGraph<N, E>::Unlink(std::size_t src, std::size_t edge) {
+  auto& node = adjacency_[src];
+  auto& sources = adjacency_[Find(node.targets[edge])].sources;
+  sources.erase(std::lower_bound(sources.begin(), sources.end(), nodes_[src]));
+  node.targets.erase(node.targets.begin() + static_cast<std::ptrdiff_t>(edge));
+  node.weights.erase(node.weights.begin() + static_cast<std::ptrdiff_t>(edge));
+  --edges_;
+}
+
+template <typename N, typename E>
+std::vector<std::tuple<N, N, E>> gdwg::FlatGraph<N, E>::Detach(std::size_t position) {
+  const N val = nodes_[position];
+  auto& node = adjacency_[position];
+  std::vector<std::tuple<N, N, E>> touching;
+  touching.reserve(node.targets.size() + node.sources.size());
+  for (std::size_t i = 0; i < node.targets.size(); ++i) {
+    touching.emplace_back(val, node.targets[i], node.weights[i]);
+  }
+  edges_ -= node.targets.size();
+
+  // Take out the edges from other nodes, visiting each source once however many edges it has
+  for (auto it = node.sources.begin(); it != node.sources.end();) {
+    const N src = *it;
+    it = std::upper_bound(it, node.sources.end(), src);
+    if (Same(src, val)) {
+      continue;
+    }
+    auto& pred = adjacency_[Find(src)];
+    auto range = EqualRange(pred, val);
+    auto first = static_cast<std::ptrdiff_t>(range.first);
+    auto last = static_cast<std::ptrdiff_t>(range.second);
+    for (auto i = first; i < last; ++i) {
+      touching.emplace_back(src, val, pred.weights[static_cast<std::size_t>(i)]);
+    }
+    pred.targets.erase(pred.targets.begin() + first, pred.targets.begin() + last);
+    pred.weights.erase(pred.weights.begin() + first, pred.weights.begin() + last);
+    edges_ -= range.second - range.first;
+  }
+
+  // Forget the node as a source of its other targets
+  for (auto it = node.targets.begin(); it != node.targets.end();) {
+    const N dst = *it;
+    it = std::upper_bound(it, node.targets.end(), dst);
+    if (!Same(dst, val)) {
+      auto& sources = adjacency_[Find(dst)].sources;
+      auto range = std::equal_range(sources.begin(), sources.end(), val);
+      sources.erase(range.first, range.second);
+    }
+  }
+
+  nodes_.erase(nodes_.begin() + static_cast<std::ptrdiff_t>(position));
+  adjacency_.erase(adjacency_.begin() + static_cast<std::ptrdiff_t>(position));
+  return touching;
+}
+
+template <typename N, typename E>
+void gdwg::FlatGraph<N, E>::SortNodes() {
+  std::sort(nodes_.begin(), nodes_.end());
+  nodes_.erase(std::unique(nodes_.begin(), nodes_.end(), Same), nodes_.end());
+  adjacency_.assign(nodes_.size(), Adjacency{});
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef ASSIGNMENTS_DG_GENERATORS_H_
+#define ASSIGNMENTS_DG_GENERATORS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+namespace gdwg {
+
+// A synthetic graph over node ids 0 to nodes - 1, for benchmarks and tests. Weights are drawn
+// uniformly from 1 to 100. Edges may repeat, and insert as one edge when they do.
+struct GeneratedGraph {
+  std::size_t nodes = 0;
+  std::vector<std::tuple<std::uint32_t, std::uint32_t, int>> edges;
+};
+
+// Erdos-Renyi G(n, m): each edge joins two nodes picked uniformly at random
+GeneratedGraph ErdosRenyi(std::size_t nodes, std::size_t edges, std::uint64_t seed = 1);
+
+// Chung-Lu graph with a power-law degree distribution: both ends of each edge are picked with
+// probability proportional to (id + 1)^(-1 / (exponent - 1)), so node 0 is the biggest hub and
+// the number of nodes of degree k falls off as k^-exponent. exponent must be above 1.
+GeneratedGraph PowerLaw(std::size_t nodes,
+                        std::size_t edges,
+                        double exponent = 2.1,
+                        std::uint64_t seed = 1);
+
+// width x height grid with edges both ways between horizontal and vertical neighbours. Node
+// (x, y) has id y * width + x.
+GeneratedGraph Grid(std::size_t width, std::size_t height, std::uint64_t seed = 1);
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_GENERATORS_H_
+
+#include "assignments/dg/generators.tpp"
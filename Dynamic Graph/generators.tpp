@@ -0,0 +1,86 @@
+#ifndef ASSIGNMENTS_DG_GENERATORS_TPP_
+#define ASSIGNMENTS_DG_GENERATORS_TPP_
+
+#include "assignments/dg/generators.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+inline gdwg::GeneratedGraph gdwg::ErdosRenyi(std::size_t nodes,
+                                             std::size_t edges,
+                                             std::uint64_t seed) {
+  GeneratedGraph graph;
+  graph.nodes = nodes;
+  if (nodes == 0) {
+    return graph;
+  }
+  std::mt19937_64 rng{seed};
+  std::uniform_int_distribution<std::uint32_t> pick{0, static_cast<std::uint32_t>(nodes - 1)};
+  std::uniform_int_distribution<int> weight{1, 100};
+  graph.edges.reserve(edges);
+  for (std::size_t i = 0; i < edges; ++i) {
+    auto src = pick(rng);
+    auto dst = pick(rng);
+    graph.edges.emplace_back(src, dst, weight(rng));
+  }
+  return graph;
+}
+
+inline gdwg::GeneratedGraph gdwg::PowerLaw(std::size_t nodes,
+                                           std::size_t edges,
+                                           double exponent,
+                                           std::uint64_t seed) {
+  GeneratedGraph graph;
+  graph.nodes = nodes;
+  if (nodes == 0) {
+    return graph;
+  }
+  // Running totals of the node weights, searched with a uniform draw to pick each end
+  std::vector<double> cumulative(nodes);
+  double total = 0;
+  for (std::size_t i = 0; i < nodes; ++i) {
+    total += std::pow(static_cast<double>(i + 1), -1 / (exponent - 1));
+    cumulative[i] = total;
+  }
+  std::mt19937_64 rng{seed};
+  std::uniform_real_distribution<double> draw{0, total};
+  std::uniform_int_distribution<int> weight{1, 100};
+  auto pick = [&] {
+    auto it = std::upper_bound(cumulative.begin(), cumulative.end(), draw(rng));
+    return static_cast<std::uint32_t>(std::min<std::size_t>(
+        static_cast<std::size_t>(it - cumulative.begin()), nodes - 1));
+  };
+  graph.edges.reserve(edges);
+  for (std::size_t i = 0; i < edges; ++i) {
+    auto src = pick();
+    auto dst = pick();
+    graph.edges.emplace_back(src, dst, weight(rng));
+  }
+  return graph;
+}
+
+inline gdwg::GeneratedGraph gdwg::Grid(std::size_t width, std::size_t height, std::uint64_t seed) {
+  GeneratedGraph graph;
+  graph.nodes = width * height;
+  std::mt19937_64 rng{seed};
+  std::uniform_int_distribution<int> weight{1, 100};
+  graph.edges.reserve(4 * graph.nodes);
+  for (std::size_t y = 0; y < height; ++y) {
+    for (std::size_t x = 0; x < width; ++x) {
+      auto id = static_cast<std::uint32_t>(y * width + x);
+      if (x + 1 < width) {
+        graph.edges.emplace_back(id, id + 1, weight(rng));
+        graph.edges.emplace_back(id + 1, id, weight(rng));
+      }
+      if (y + 1 < height) {
+        auto below = static_cast<std::uint32_t>(id + width);
+        graph.edges.emplace_back(id, below, weight(rng));
+        graph.edges.emplace_back(below, id, weight(rng));
+      }
+    }
+  }
+  return graph;
+}
+
+#endif
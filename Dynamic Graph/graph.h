@@ -2,38 +2,138 @@
 #define ASSIGNMENTS_DG_GRAPH_H_
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <map>
 #include <memory>
-#include <set>
+#include <memory_resource>
+#include <scoped_allocator>
 #include <tuple>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "assignments/dg/csr_graph.h"
+#include "assignments/dg/instrument.h"
+#include "assignments/dg/node_index.h"
+#include "assignments/dg/pool_allocator.h"
+#include "assignments/dg/small_set.h"
+
 namespace gdwg {
+namespace detail {
+
+// Whether std::hash can hash T
+template <typename T, typename = void>
+struct IsHashable : std::false_type {};
+template <typename T>
+struct IsHashable<T, std::void_t<decltype(std::hash<T>{}(std::declval<const T&>()))>>
+  : std::true_type {};
+
+// Spreads the bits of a hash (the splitmix64 finaliser), so sums of hashes don't collide for
+// values with similar std::hash results
+inline std::uint64_t MixHash(std::uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+}  // namespace detail
+
+// Outcome of a Graph Try* call
+enum class GraphStatus : std::uint8_t {
+  kOk,
+  // Nothing to do: the edge to insert or the node to rename to is already there
+  kExists,
+  // The first or second node named isn't in the graph. For Replace and MergeReplace these are
+  // the old and the new node.
+  kMissingSrc,
+  kMissingDst,
+  // Both nodes are there but the edge to erase isn't
+  kMissingEdge,
+};
 
 template <typename N, typename E>
 class Graph {
  public:
-  // Comparison function for map of nodes
+  // Nodes and edges are owned through pointers into the graph's pool
+  using node_ptr = pool_ptr<N>;
+  using edge_ptr = pool_ptr<std::tuple<N&, E>>;
+
+  // Comparison function for map of nodes. Transparent so a node can be looked up by value
+  // without allocating a node_ptr for the key.
   struct mapCompare {
-    bool operator()(const std::unique_ptr<N>& lhs, const std::unique_ptr<N>& rhs) const {
+    using is_transparent = void;
+
+    bool operator()(const node_ptr& lhs, const node_ptr& rhs) const {
       return *lhs < *rhs;
     }
+    bool operator()(const node_ptr& lhs, const N& rhs) const { return *lhs < rhs; }
+    bool operator()(const N& lhs, const node_ptr& rhs) const { return lhs < *rhs; }
   };
 
-  // Comparison function for set of edges
+  // Key used to look up a single edge in a set of edges
+  using edge_key = std::tuple<const N&, const E&>;
+
+  // Comparison function for set of edges. Transparent so edges can be looked up by (dst, weight)
+  // or by dst alone, in which case equal_range returns every edge to that dst.
   struct setCompare {
-    bool operator()(const std::unique_ptr<std::tuple<N&, E>>& lhs,
-                    const std::unique_ptr<std::tuple<N&, E>>& rhs) const {
+    using is_transparent = void;
+
+    bool operator()(const edge_ptr& lhs, const edge_ptr& rhs) const {
       return (std::get<0>(*lhs) < std::get<0>(*rhs)) ||
              (std::get<0>(*lhs) == std::get<0>(*rhs) && std::get<1>(*lhs) < std::get<1>(*rhs));
     }
+    bool operator()(const edge_ptr& lhs, const edge_key& rhs) const {
+      return (std::get<0>(*lhs) < std::get<0>(rhs)) ||
+             (std::get<0>(*lhs) == std::get<0>(rhs) && std::get<1>(*lhs) < std::get<1>(rhs));
+    }
+    bool operator()(const edge_key& lhs, const edge_ptr& rhs) const {
+      return (std::get<0>(lhs) < std::get<0>(*rhs)) ||
+             (std::get<0>(lhs) == std::get<0>(*rhs) && std::get<1>(lhs) < std::get<1>(*rhs));
+    }
+    bool operator()(const edge_ptr& lhs, const N& rhs) const {
+      return std::get<0>(*lhs) < rhs;
+    }
+    bool operator()(const N& lhs, const edge_ptr& rhs) const {
+      return lhs < std::get<0>(*rhs);
+    }
   };
 
-  // Edge type declaration
-  using edge = std::set<std::unique_ptr<std::tuple<N&, E>>, setCompare>;
+  // Edge type declaration. A node's edges are kept in a sorted array until there are more than
+  // kFlatEdges of them, and in a tree after that.
+  static constexpr std::size_t kFlatEdges = 32;
+  using edge = SmallSet<edge_ptr, setCompare, PoolAllocator<edge_ptr>, kFlatEdges>;
+  using node_map =
+      std::map<node_ptr, edge, mapCompare, PoolAllocator<std::pair<const node_ptr, edge>>>;
+
+  // Reverse adjacency: for each node, the nodes with edges into it and how many edges each has
+  using predecessor_counts =
+      std::unordered_map<const N*,
+                         std::size_t,
+                         std::hash<const N*>,
+                         std::equal_to<const N*>,
+                         PoolAllocator<std::pair<const N* const, std::size_t>>>;
+  using predecessor_map = std::unordered_map<
+      const N*,
+      predecessor_counts,
+      std::hash<const N*>,
+      std::equal_to<const N*>,
+      std::scoped_allocator_adaptor<PoolAllocator<std::pair<const N* const, predecessor_counts>>>>;
+
+  // One edge change in a batch passed to Apply
+  struct Mutation {
+    enum class Op : std::uint8_t { kInsert, kErase };
+
+    Op op;
+    N src;
+    N dst;
+    E weight;
+  };
 
   // Custom iterator
   class const_iterator {
@@ -43,11 +143,15 @@ class Graph {
     using iterator_category = std::bidirectional_iterator_tag;
     using value_type = std::tuple<N, N, E>;
     using reference = std::tuple<const N&, const N&, const E&>;
-    using pointer = std::tuple<N, N, E>*;
+    // operator* returns a tuple of references by value, so operator-> hands out a copy of it
+    struct pointer {
+      reference value;
+      const reference* operator->() const { return &value; }
+    };
     using difference_type = int;
 
     reference operator*();
-    pointer operator->() const { return &(operator*()); }
+    pointer operator->() { return pointer{operator*()}; }
     const_iterator& operator++();
     const const_iterator operator++(int) {
       auto const copy{*this};
@@ -69,9 +173,9 @@ class Graph {
     friend bool operator!=(const_iterator lhs, const_iterator rhs) { return !(lhs == rhs); }
 
    private:
-    typename std::map<std::unique_ptr<N>, edge, mapCompare>::const_iterator key_;
-    typename std::map<std::unique_ptr<N>, edge, mapCompare>::const_iterator begin_;
-    typename std::map<std::unique_ptr<N>, edge, mapCompare>::const_iterator end_;
+    typename node_map::const_iterator key_;
+    typename node_map::const_iterator begin_;
+    typename node_map::const_iterator end_;
     typename edge::const_iterator value_;
 
     friend class Graph;
@@ -86,6 +190,80 @@ class Graph {
       : key_{key}, begin_{begin}, end_{key} {}
   };
 
+  // View over a run of edges, in the same order as const_iterator. It is a few iterators to
+  // copy, and Split() cuts it into runs of near equal edge count so a scan of every edge can be
+  // spread over threads. Like const_iterator, it is invalidated by changes to the graph.
+  class edge_range {
+   public:
+    class iterator {
+     public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = std::tuple<N, N, E>;
+      using reference = std::tuple<const N&, const N&, const E&>;
+      using pointer = void;
+      using difference_type = std::ptrdiff_t;
+
+      reference operator*() const { return {Source(), Destination(), Weight()}; }
+      iterator& operator++() {
+        ++value_;
+        SkipEmpty();
+        return *this;
+      }
+      iterator operator++(int) {
+        auto copy{*this};
+        ++(*this);
+        return copy;
+      }
+      friend bool operator==(const iterator& lhs, const iterator& rhs) {
+        return lhs.key_ == rhs.key_ && (lhs.key_ == lhs.end_ || lhs.value_ == rhs.value_);
+      }
+      friend bool operator!=(const iterator& lhs, const iterator& rhs) { return !(lhs == rhs); }
+
+      // The parts of the current edge, without building a tuple
+      const N& Source() const { return *key_->first; }
+      const N& Destination() const { return std::get<0>(**value_); }
+      const E& Weight() const { return std::get<1>(**value_); }
+
+     private:
+      typename node_map::const_iterator key_;
+      typename node_map::const_iterator end_;
+      typename edge::const_iterator value_;
+
+      friend class Graph;
+
+      iterator(typename node_map::const_iterator key,
+               typename node_map::const_iterator end,
+               typename edge::const_iterator value)
+        : key_{key}, end_{end}, value_{value} {}
+
+      // Moves past nodes without edges, so the iterator is at an edge or at the end
+      void SkipEmpty() {
+        while (key_ != end_ && value_ == key_->second.end()) {
+          if (++key_ != end_) {
+            value_ = key_->second.begin();
+          }
+        }
+      }
+    };
+
+    iterator begin() const { return first_; }
+    iterator end() const { return last_; }
+    bool empty() const { return first_ == last_; }
+    // Number of edges in the range. Linear in the nodes it covers.
+    std::size_t size() const;
+    // Cuts the range into at most parts consecutive, non-empty runs whose edge counts differ by
+    // at most one. Linear in the nodes covered plus the edges of any node a cut falls inside.
+    std::vector<edge_range> Split(std::size_t parts) const;
+
+   private:
+    iterator first_;
+    iterator last_;
+
+    friend class Graph;
+
+    edge_range(iterator first, iterator last) : first_{first}, last_{last} {}
+  };
+
   // Iterator methods
   const_iterator begin() const;
   const_iterator end() const;
@@ -109,6 +287,13 @@ class Graph {
         typename std::vector<std::tuple<N, N, E>>::const_iterator);
   Graph(std::initializer_list<N>);
   Graph(Graph<N, E>&&) noexcept;
+  // Builds a graph from a range of (src, dst, weight) tuples, sorting and deduplicating them in
+  // one batch. Pass move iterators to move the tuples in rather than copying them.
+  template <typename InputIt>
+  static Graph<N, E> BulkLoad(InputIt first, InputIt last);
+  // Builds a graph from a frozen one. Its nodes and edges are already sorted and distinct, so
+  // they are appended in order without searching.
+  static Graph<N, E> Thaw(const CsrGraph<N, E>& frozen);
   // Destructors
   ~Graph<N, E>() noexcept;
   // Operators
@@ -126,24 +311,61 @@ class Graph {
   std::vector<N> GetNodes();
   std::vector<N> GetConnected(const N& src);
   std::vector<E> GetWeights(const N& src, const N& dst);
+  std::vector<N> GetPredecessors(const N& dst);
+  // The same without exceptions or output, for loops where bad input is common. Results are
+  // written to out, reusing its storage, only when the status is kOk.
+  GraphStatus TryInsertEdge(const N& src, const N& dst, const E& w);
+  GraphStatus TryErase(const N& src, const N& dst, const E& w);
+  GraphStatus TryReplace(const N& oldData, const N& newData);
+  GraphStatus TryMergeReplace(const N& oldData, const N& newData);
+  GraphStatus TryIsConnected(const N& src, const N& dst, bool& connected) const;
+  GraphStatus TryGetConnected(const N& src, std::vector<N>& out) const;
+  GraphStatus TryGetWeights(const N& src, const N& dst, std::vector<E>& out) const;
+  // Fails with kMissingDst, as dst is the node the predecessors are of
+  GraphStatus TryGetPredecessors(const N& dst, std::vector<N>& out) const;
+  // Applies a batch of edge inserts and erases and returns how many changed the graph.
+  // Every node the batch names is looked up once, and an insert creates any node it needs.
+  // Changes are applied grouped by source and in edge order, so each edge set is filled with
+  // hinted inserts. Changes to the same edge keep their order in the batch.
+  std::size_t Apply(const std::vector<Mutation>& batch);
+  // Applies each change in order with TryInsertEdge or TryErase and returns their statuses.
+  // Unlike Apply it never creates nodes.
+  std::vector<GraphStatus> TryApply(const std::vector<Mutation>& batch);
+  CsrGraph<N, E> Freeze() const;
+  // Order independent hash of the nodes and edges, kept up to date by every change, so equal
+  // graphs have equal fingerprints. Always 0 if N or E has no std::hash.
+  std::uint64_t Fingerprint() const { return fingerprint_; }
+
+  // Read-only view of the stored nodes and their edge sets, for algorithms that walk the graph
+  // without copying node values. Node addresses are stable until the node is deleted.
+  const node_map& Adjacency() const { return graph_; }
+  // The same for edges into each node, keyed by the addresses Adjacency() stores. A node with
+  // no edges into it has no entry.
+  const predecessor_map& Predecessors() const { return predecessors_; }
+  // Every edge, as a range that can be split between threads
+  edge_range Edges() const;
   bool erase(const N& src, const N& dst, const E& w);
 
   // Friends
   friend class const_iterator;
   friend std::ostream& operator<<(std::ostream& os, const Graph<N, E>& source) {
     for (auto it = source.graph_.begin(); it != source.graph_.end(); ++it) {
-      std::cout << *(it->first) << " (\n";
+      os << *(it->first) << " (\n";
       for (auto jt = it->second.begin(); jt != it->second.end(); ++jt) {
-        // first * dereferences iterator, second * dereferences unique_ptr
-        std::cout << "\t" << std::get<0>(*(*jt)) << " | " << std::get<1>(*(*jt)) << "\n";
+        // first * dereferences iterator, second * dereferences edge_ptr
+        os << "\t" << std::get<0>(*(*jt)) << " | " << std::get<1>(*(*jt)) << "\n";
       }
-      std::cout << ")\n";
+      os << ")\n";
     }
 
     return os;
   }
 
   friend bool operator==(const gdwg::Graph<N, E>& lhs, const gdwg::Graph<N, E>& rhs) {
+    // Only graphs that could be equal are walked
+    if (lhs.fingerprint_ != rhs.fingerprint_ || lhs.graph_.size() != rhs.graph_.size()) {
+      return false;
+    }
     auto first_iterator = lhs.graph_.begin();
     auto second_iterator = rhs.graph_.begin();
 
@@ -178,7 +400,35 @@ class Graph {
   }
 
  private:
-  std::map<std::unique_ptr<N>, edge, mapCompare> graph_;
+  // Pool allocation helpers
+  node_ptr MakeNode(const N& val);
+  edge_ptr MakeEdge(N& dst, const E& w);
+  edge MakeEdgeSet();
+  void LeaveEmpty() noexcept;
+
+  // Fingerprint terms. Edge terms take the std::hash of their nodes, so callers that visit
+  // many edges of one node can hash it once.
+  static constexpr bool kHashable = detail::IsHashable<N>::value && detail::IsHashable<E>::value;
+  static std::uint64_t HashNode(const N& val);
+  static std::uint64_t NodeTerm(std::uint64_t node);
+  static std::uint64_t EdgeTerm(std::uint64_t src, std::uint64_t dst, const E& w);
+  // Terms of a node and every edge into or out of it
+  std::uint64_t TouchingTerms(typename node_map::const_iterator node) const;
+
+  // Edge helpers that keep predecessors_ and fingerprint_ in step with graph_
+  bool LinkEdge(typename node_map::iterator src, N& dst, const E& w);
+  typename edge::iterator UnlinkEdge(typename node_map::iterator src, typename edge::iterator it);
+  void UnlinkPredecessor(const N* dst, const N* src);
+
+  // Nodes, edges and the containers holding them are allocated from pool_. It lives on the heap so
+  // it keeps its address when the containers using it are moved to another graph.
+  std::unique_ptr<std::pmr::unsynchronized_pool_resource> pool_ =
+      std::make_unique<std::pmr::unsynchronized_pool_resource>();
+  node_map graph_{PoolAllocator<std::pair<const node_ptr, edge>>{pool_.get()}};
+  predecessor_map predecessors_{
+      typename predecessor_map::allocator_type{PoolAllocator<char>{pool_.get()}}};
+  // Sum of the terms of every node and edge
+  std::uint64_t fingerprint_ = 0;
 };
 
 }  // namespace gdwg
@@ -5,6 +5,9 @@
 
 #include <algorithm>
 #include <memory>
+#include <new>
+#include <numeric>
+#include <type_traits>
 #include <utility>
 
 // Begin constructors
@@ -21,44 +24,32 @@ gdwg::Graph<N, E>::Graph(typename std::vector<N>::const_iterator start,
 }
 
 template <typename N, typename E>
-gdwg::Graph<N, E>::Graph(const gdwg::Graph<N, E>& source) {
-  // Copy construct nodes
+gdwg::Graph<N, E>::Graph(const gdwg::Graph<N, E>& source) : fingerprint_{source.fingerprint_} {
+  // Copy construct nodes, remembering which copy belongs to which source node. The source is
+  // already sorted, so every node is appended at the end of the map.
+  std::unordered_map<const N*, N*> remap;
+  remap.reserve(source.graph_.size());
   for (auto it = source.graph_.begin(); it != source.graph_.end(); it++) {
-    graph_[std::make_unique<N>(*(it->first))] = edge();
+    auto copy = graph_.emplace_hint(graph_.end(), MakeNode(*(it->first)), MakeEdgeSet());
+    copy->second.reserve(it->second.size());
+    remap.emplace(it->first.get(), copy->first.get());
   }
 
-  // Copy construct edges
-  for (auto it = source.graph_.begin(); it != source.graph_.end(); it++) {
-    if (it->second.size() != 0) {
-      for (auto iter = it->second.begin(); iter != it->second.end(); iter++) {
-        N node = std::get<0>(*(*iter));
-
-        // Find the destination node to be connected to
-        auto search = find_if(graph_.begin(), graph_.end(),
-                              [&node](auto const& pair) { return *pair.first == node; });
-        E value = std::get<1>(*(*iter));
-        graph_[std::make_unique<N>(*(it->first))].emplace(
-            std::make_unique<std::tuple<N&, E>>(std::forward_as_tuple(*search->first, value)));
-      }
+  // Copy construct edges in the same single pass, appending to each sorted edge set
+  auto copy = graph_.begin();
+  for (auto it = source.graph_.begin(); it != source.graph_.end(); it++, copy++) {
+    for (auto iter = it->second.begin(); iter != it->second.end(); iter++) {
+      N* dst = remap.find(&std::get<0>(*(*iter)))->second;
+      copy->second.emplace_hint(copy->second.end(), MakeEdge(*dst, std::get<1>(*(*iter))));
+      ++predecessors_[dst][copy->first.get()];
     }
   }
 }
 
 template <typename N, typename E>
 gdwg::Graph<N, E>::Graph(typename std::vector<std::tuple<N, N, E>>::const_iterator start,
-                         typename std::vector<std::tuple<N, N, E>>::const_iterator end) {
-  while (start != end) {
-    N source = std::get<0>(*start);
-    N destination = std::get<1>(*start);
-    E weight = std::get<2>(*start);
-    if (!IsNode(source))
-      InsertNode(source);
-    if (!IsNode(destination))
-      InsertNode(destination);
-    InsertEdge(source, destination, weight);
-    start++;
-  }
-}
+                         typename std::vector<std::tuple<N, N, E>>::const_iterator end)
+  : Graph{BulkLoad(start, end)} {}
 
 template <typename N, typename E>
 gdwg::Graph<N, E>::Graph(std::initializer_list<N> input_list) {
@@ -67,95 +58,236 @@ gdwg::Graph<N, E>::Graph(std::initializer_list<N> input_list) {
 }
 
 template <typename N, typename E>
-gdwg::Graph<N, E>::Graph(gdwg::Graph<N, E>&& source) noexcept {
-  for (auto it = source.graph_.begin(); it != source.graph_.end(); it++) {
-    graph_[std::make_unique<N>(*(it->first))] = edge();
+gdwg::Graph<N, E>::Graph(gdwg::Graph<N, E>&& source) noexcept
+  : pool_{std::move(source.pool_)}, graph_{std::move(source.graph_)},
+    predecessors_{std::move(source.predecessors_)}, fingerprint_{source.fingerprint_} {
+  // Nodes keep their addresses, so edges and predecessors_ stay valid without being touched
+  source.LeaveEmpty();
+}
+template <typename N, typename E>
+template <typename InputIt>
+gdwg::Graph<N, E> gdwg::Graph<N, E>::BulkLoad(InputIt first, InputIt last) {
+  // Sort the edges into the order the graph stores them in and drop duplicates
+  std::vector<std::tuple<N, N, E>> edges;
+  for (; first != last; ++first) {
+    edges.emplace_back(*first);
   }
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
 
-  // Copy construct edges
-  for (auto it = source.graph_.begin(); it != source.graph_.end(); it++) {
-    if (it->second.size() != 0) {
-      for (auto iter = it->second.begin(); iter != it->second.end(); iter++) {
-        N node = std::get<0>(*(*iter));
-
-        // Find the destination node to be connected to
-        auto search = find_if(graph_.begin(), graph_.end(),
-                              [&node](auto const& pair) { return *pair.first == node; });
-        E value = std::get<1>(*(*iter));
-        graph_[std::make_unique<N>(*(it->first))].emplace(
-            std::make_unique<std::tuple<N&, E>>(std::forward_as_tuple(*search->first, value)));
+  // Also order the destinations, so they can be matched to nodes in one pass. They are moved out
+  // of the edges and sorted with the edge they came from, which keeps the sort cache friendly.
+  std::vector<std::pair<N, std::size_t>> by_dst;
+  by_dst.reserve(edges.size());
+  for (std::size_t i = 0; i < edges.size(); ++i) {
+    by_dst.emplace_back(std::move(std::get<1>(edges[i])), i);
+  }
+  std::sort(by_dst.begin(), by_dst.end(),
+            [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+  // Sorted, distinct nodes are the union of the distinct sources and destinations
+  std::vector<const N*> sources;
+  std::vector<const N*> destinations;
+  for (const auto& edge_tuple : edges) {
+    if (sources.empty() || *sources.back() < std::get<0>(edge_tuple)) {
+      sources.push_back(&std::get<0>(edge_tuple));
+    }
+  }
+  for (const auto& dst : by_dst) {
+    if (destinations.empty() || *destinations.back() < dst.first) {
+      destinations.push_back(&dst.first);
+    }
+  }
+  std::vector<const N*> nodes;
+  nodes.reserve(sources.size() + destinations.size());
+  std::set_union(sources.begin(), sources.end(), destinations.begin(), destinations.end(),
+                 std::back_inserter(nodes), [](const N* lhs, const N* rhs) { return *lhs < *rhs; });
+
+  // Every node is appended at the end of the map
+  Graph<N, E> graph;
+  std::vector<N*> stored;
+  stored.reserve(nodes.size());
+  for (const N* node : nodes) {
+    auto it =
+        graph.graph_.emplace_hint(graph.graph_.end(), graph.MakeNode(*node), graph.MakeEdgeSet());
+    stored.push_back(it->first.get());
+    graph.fingerprint_ += NodeTerm(HashNode(*node));
+  }
+
+  // Match every destination to its node
+  std::vector<N*> dst_nodes(edges.size());
+  auto node = stored.begin();
+  for (const auto& dst : by_dst) {
+    while (**node < dst.first) {
+      ++node;
+    }
+    dst_nodes[dst.second] = *node;
+  }
+
+  // Every edge is appended at the end of its source's set
+  std::vector<const N*> src_nodes(edges.size());
+  auto src = graph.graph_.begin();
+  std::uint64_t src_hash = 0;
+  for (std::size_t i = 0; i < edges.size(); ++i) {
+    while (*src->first < std::get<0>(edges[i])) {
+      ++src;
+    }
+    if (src->second.empty()) {
+      auto run = i + 1;
+      while (run < edges.size() && !(std::get<0>(edges[i]) < std::get<0>(edges[run]))) {
+        ++run;
       }
+      src->second.reserve(run - i);
+      src_hash = HashNode(*src->first);
     }
+    src->second.emplace_hint(src->second.end(),
+                             graph.MakeEdge(*dst_nodes[i], std::get<2>(edges[i])));
+    graph.fingerprint_ += EdgeTerm(src_hash, HashNode(*dst_nodes[i]), std::get<2>(edges[i]));
+    src_nodes[i] = src->first.get();
   }
 
-  source.graph_.clear();
+  // Count predecessors one destination at a time
+  graph.predecessors_.reserve(destinations.size());
+  for (std::size_t i = 0; i < by_dst.size();) {
+    auto& counts = graph.predecessors_[dst_nodes[by_dst[i].second]];
+    std::size_t j = i;
+    while (j < by_dst.size() && dst_nodes[by_dst[j].second] == dst_nodes[by_dst[i].second]) {
+      ++j;
+    }
+    counts.reserve(j - i);
+    for (; i < j; ++i) {
+      ++counts[src_nodes[by_dst[i].second]];
+    }
+  }
+  return graph;
+}
+
+template <typename N, typename E>
+gdwg::Graph<N, E> gdwg::Graph<N, E>::Thaw(const CsrGraph<N, E>& frozen) {
+  Graph<N, E> graph;
+  std::vector<typename node_map::iterator> stored;
+  std::vector<std::uint64_t> hashes;
+  stored.reserve(frozen.NodeCount());
+  hashes.reserve(frozen.NodeCount());
+  for (const auto& node : frozen.Nodes()) {
+    stored.push_back(
+        graph.graph_.emplace_hint(graph.graph_.end(), graph.MakeNode(node), graph.MakeEdgeSet()));
+    hashes.push_back(HashNode(node));
+    graph.fingerprint_ += NodeTerm(hashes.back());
+  }
+
+  const auto& offsets = frozen.Offsets();
+  const auto& targets = frozen.Targets();
+  const auto& weights = frozen.Weights();
+  for (std::size_t src = 0; src < stored.size(); ++src) {
+    auto& edges = stored[src]->second;
+    edges.reserve(offsets[src + 1] - offsets[src]);
+    for (auto i = offsets[src]; i < offsets[src + 1]; ++i) {
+      edges.emplace_hint(edges.end(), graph.MakeEdge(*stored[targets[i]]->first, weights[i]));
+      graph.fingerprint_ += EdgeTerm(hashes[src], hashes[targets[i]], weights[i]);
+    }
+  }
+
+  // The frozen graph's reverse index gives each node's predecessors directly
+  for (std::size_t dst = 0; dst < stored.size(); ++dst) {
+    auto sources = frozen.Sources(static_cast<typename CsrGraph<N, E>::node_id>(dst));
+    if (sources.empty()) {
+      continue;
+    }
+    auto& counts = graph.predecessors_[stored[dst]->first.get()];
+    counts.reserve(sources.size());
+    for (auto src : sources) {
+      ++counts[stored[src]->first.get()];
+    }
+  }
+  return graph;
 }
 // end constructors
 
 // destructor
 
 template <typename N, typename E>
-gdwg::Graph<N, E>::~Graph<N, E>() noexcept = default;
+gdwg::Graph<N, E>::~Graph<N, E>() noexcept {
+  // Clear frees the pool in whole chunks, which is cheaper than the containers freeing each node
+  Clear();
+}
 
 template <typename N, typename E>
 bool gdwg::Graph<N, E>::InsertNode(const N& val) {
-  auto search = find_if(graph_.begin(), graph_.end(),
-                        [&val](auto const& pair) { return *pair.first == val; });
+  GDWG_OBSERVE(kInsertNode);
+  GDWG_VISIT(1, 0);
+  // lower_bound doubles as the insertion hint, so the tree is only searched once
+  auto search = graph_.lower_bound(val);
 
-  if (search != graph_.end()) {
+  if (search != graph_.end() && !(val < *search->first)) {
     return false;
   } else {
-    graph_[std::make_unique<N>(val)] = edge();
+    graph_.emplace_hint(search, MakeNode(val), MakeEdgeSet());
+    fingerprint_ += NodeTerm(HashNode(val));
     return true;
   }
 }
 
 template <typename N, typename E>
 bool gdwg::Graph<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
-  try {
-    // Search graph for source node
-    auto search_src = find_if(graph_.begin(), graph_.end(),
-                              [&src](auto const& pair) { return *pair.first == src; });
-    // Search graph for dst node
-    auto search_dst = find_if(graph_.begin(), graph_.end(),
-                              [&dst](auto const& pair) { return *pair.first == dst; });
-    if (search_src == graph_.end() || search_dst == graph_.end()) {
-      throw std::runtime_error(
-          "Cannot call Graph::InsertEdge when either src or dst node does not exist");
-    }
-
-    // Search source node edge list for dst node and w edge weight
-    auto search_vec =
-        find_if(search_src->second.begin(), search_src->second.end(), [&dst, &w](auto const& pair) {
-          return (std::get<0>(*pair) == dst && std::get<1>(*pair) == w);
-        });
+  auto status = TryInsertEdge(src, dst, w);
+  if (status == GraphStatus::kMissingSrc || status == GraphStatus::kMissingDst) {
+    std::cout << "Cannot call Graph::InsertEdge when either src or dst node does not exist\n";
+  }
+  return status == GraphStatus::kOk;
+}
 
-    // If edge not found, create new one
-    if (search_vec == search_src->second.end()) {
-      search_src->second.emplace(
-          std::make_unique<std::tuple<N&, E>>(std::forward_as_tuple(*search_dst->first, w)));
-      return true;
-    }
-  } catch (const std::runtime_error& e) {
-    std::cout << e.what() << '\n';
+template <typename N, typename E>
+gdwg::GraphStatus gdwg::Graph<N, E>::TryInsertEdge(const N& src, const N& dst, const E& w) {
+  GDWG_OBSERVE(kInsertEdge);
+  auto search_src = graph_.find(src);
+  auto search_dst = graph_.find(dst);
+  GDWG_VISIT(2, 0);
+  if (search_src == graph_.end()) {
+    return GraphStatus::kMissingSrc;
+  }
+  if (search_dst == graph_.end()) {
+    return GraphStatus::kMissingDst;
+  }
+  // Create the edge unless it already exists
+  if (!LinkEdge(search_src, *search_dst->first, w)) {
+    return GraphStatus::kExists;
   }
-  return false;
+  GDWG_VISIT(0, 1);
+  return GraphStatus::kOk;
 }
 
 template <typename N, typename E>
 bool gdwg::Graph<N, E>::DeleteNode(const N& val) {
-  auto search = find_if(graph_.begin(), graph_.end(),
-                        [&val](auto const& pair) { return (*pair.first == val); });
+  GDWG_OBSERVE(kDeleteNode);
+  auto search = graph_.find(val);
+  GDWG_VISIT(1, 0);
   if (search == graph_.end()) {
     return false;
   } else {
-    // Delete edges connected to target node
-    for (auto it = graph_.begin(); it != graph_.end(); ++it) {
-      for (auto jt = it->second.begin(); jt != it->second.end();) {
-        if (std::get<0>(*(*jt)) == *search->first) {
-          it->second.erase(jt);
-        } else {
-          ++jt;
+    const N* node = search->first.get();
+    fingerprint_ -= TouchingTerms(search);
+
+    // Delete edges into the target node
+    auto incoming = predecessors_.find(node);
+    if (incoming != predecessors_.end()) {
+      for (const auto& pred : incoming->second) {
+        auto& edges = graph_.find(*pred.first)->second;
+        auto range = edges.equal_range(val);
+        GDWG_VISIT(1, static_cast<std::size_t>(std::distance(range.first, range.second)));
+        edges.erase(range.first, range.second);
+      }
+      predecessors_.erase(incoming);
+    }
+
+    // Forget the target node as a predecessor of its successors
+    GDWG_VISIT(0, search->second.size());
+    for (const auto& out : search->second) {
+      auto outgoing = predecessors_.find(&std::get<0>(*out));
+      if (outgoing != predecessors_.end()) {
+        outgoing->second.erase(node);
+        if (outgoing->second.empty()) {
+          predecessors_.erase(outgoing);
         }
       }
     }
@@ -168,102 +300,184 @@ bool gdwg::Graph<N, E>::DeleteNode(const N& val) {
 
 template <typename N, typename E>
 bool gdwg::Graph<N, E>::Replace(const N& oldData, const N& newData) {
-  try {
-    auto search = find_if(graph_.begin(), graph_.end(),
-                          [&oldData](auto const& pair) { return (*pair.first == oldData); });
-    if (search == graph_.end()) {
-      throw std::runtime_error("Cannot call Graph::Replace on a node that doesn't exist");
-    }
+  auto status = TryReplace(oldData, newData);
+  if (status == GraphStatus::kMissingSrc) {
+    std::cout << "Cannot call Graph::Replace on a node that doesn't exist\n";
+  }
+  return status == GraphStatus::kOk;
+}
+
+template <typename N, typename E>
+gdwg::GraphStatus gdwg::Graph<N, E>::TryReplace(const N& oldData, const N& newData) {
+  auto search = graph_.find(oldData);
+  if (search == graph_.end()) {
+    return GraphStatus::kMissingSrc;
+  }
+  if (graph_.find(newData) != graph_.end()) {
+    return GraphStatus::kExists;
+  }
+
+  // Every term with the node in it changes
+  auto old_terms = TouchingTerms(search);
+
+  // The node is a key of graph_ and of every edge pointing at it, so take it out of the map
+  // before changing it. Extracting keeps the node_ptr, so edge references stay valid.
+  auto handle = graph_.extract(search);
+  N* node = handle.key().get();
+  *node = newData;
+  auto renamed = graph_.insert(std::move(handle)).position;
 
-    auto search_new = find_if(graph_.begin(), graph_.end(),
-                              [&newData](auto const& pair) { return (*pair.first == newData); });
-    if (search_new == graph_.end()) {
-      *search->first = newData;
-      return true;
+  // Re-sort the edges pointing at the renamed node. Predecessor counts are unchanged.
+  auto incoming = predecessors_.find(node);
+  if (incoming != predecessors_.end()) {
+    for (const auto& pred : incoming->second) {
+      auto& edges = graph_.find(*pred.first)->second;
+      std::vector<E> weights;
+      for (auto it = edges.begin(); it != edges.end();) {
+        if (&std::get<0>(*(*it)) == node) {
+          weights.push_back(std::get<1>(*(*it)));
+          it = edges.erase(it);
+        } else {
+          ++it;
+        }
+      }
+      for (const auto& weight : weights) {
+        edges.emplace(MakeEdge(*node, weight));
+      }
     }
-  } catch (const std::runtime_error& e) {
-    std::cout << e.what() << '\n';
   }
-  return false;
+  fingerprint_ += TouchingTerms(renamed) - old_terms;
+  return GraphStatus::kOk;
 }
 
 template <typename N, typename E>
 void gdwg::Graph<N, E>::MergeReplace(const N& oldData, const N& newData) {
-  try {
-    // Search graph for old node
-    auto search_old = find_if(graph_.begin(), graph_.end(),
-                              [&oldData](auto const& pair) { return *pair.first == oldData; });
-    // Search graph for new node
-    auto search_new = find_if(graph_.begin(), graph_.end(),
-                              [&newData](auto const& pair) { return *pair.first == newData; });
-    if (search_old == graph_.end() || search_new == graph_.end()) {
-      throw std::runtime_error(
-          "Cannot call Graph::MergeReplace on old or new data if they don't exist in the graph");
-    }
-
-    // Merge old node edges to new
-    search_new->second.merge(search_old->second);
-    search_old->second.clear();
-
-    // Redirect incoming edges from old node to new
-    for (auto it = graph_.begin(); it != graph_.end(); ++it) {
-      for (auto iter = it->second.begin(); iter != it->second.end(); ++iter) {
-        if (std::get<0>(*(*iter)) == oldData) {
-          it->second.emplace(std::make_unique<std::tuple<N&, E>>(
-              std::forward_as_tuple(*search_new->first, std::get<1>(*(*iter)))));
-          it->second.erase(iter);
-        }
+  auto status = TryMergeReplace(oldData, newData);
+  if (status == GraphStatus::kMissingSrc || status == GraphStatus::kMissingDst) {
+    std::cout
+        << "Cannot call Graph::MergeReplace on old or new data if they don't exist in the graph\n";
+  }
+}
+
+template <typename N, typename E>
+gdwg::GraphStatus gdwg::Graph<N, E>::TryMergeReplace(const N& oldData, const N& newData) {
+  GDWG_OBSERVE(kMergeReplace);
+  auto search_old = graph_.find(oldData);
+  auto search_new = graph_.find(newData);
+  GDWG_VISIT(2, 0);
+  if (search_old == graph_.end()) {
+    return GraphStatus::kMissingSrc;
+  }
+  if (search_new == graph_.end()) {
+    return GraphStatus::kMissingDst;
+  }
+  if (search_old == search_new) {
+    return GraphStatus::kOk;
+  }
+
+  const N* old_node = search_old->first.get();
+  const N* new_node = search_new->first.get();
+
+  // Redirect incoming edges from old node to new
+  auto incoming = predecessors_.find(old_node);
+  if (incoming != predecessors_.end()) {
+    std::vector<const N*> preds;
+    for (const auto& pred : incoming->second) {
+      preds.push_back(pred.first);
+    }
+    for (const N* pred : preds) {
+      auto search_pred = graph_.find(*pred);
+      std::vector<E> weights;
+      auto iter = search_pred->second.lower_bound(oldData);
+      while (iter != search_pred->second.end() && &std::get<0>(*(*iter)) == old_node) {
+        weights.push_back(std::get<1>(*(*iter)));
+        iter = UnlinkEdge(search_pred, iter);
+      }
+      for (const auto& weight : weights) {
+        LinkEdge(search_pred, *search_new->first, weight);
       }
+      GDWG_VISIT(1, weights.size());
     }
+  }
 
-    // Delete old node
-    graph_.erase(search_old);
-  } catch (const std::runtime_error& e) {
-    std::cout << e.what() << '\n';
+  // Move old node edges to new. Edges already present in new are dropped.
+  auto old_hash = HashNode(oldData);
+  auto new_hash = HashNode(newData);
+  GDWG_VISIT(0, search_old->second.size());
+  while (!search_old->second.empty()) {
+    auto moved = search_old->second.extract(search_old->second.begin());
+    const N* dst = &std::get<0>(*moved);
+    auto dst_hash = HashNode(*dst);
+    const E& weight = std::get<1>(*moved);
+    fingerprint_ -= EdgeTerm(old_hash, dst_hash, weight);
+    UnlinkPredecessor(dst, old_node);
+    auto term = EdgeTerm(new_hash, dst_hash, weight);
+    if (search_new->second.insert(std::move(moved)).second) {
+      ++predecessors_[dst][new_node];
+      fingerprint_ += term;
+    }
   }
+
+  // Delete old node
+  fingerprint_ -= NodeTerm(old_hash);
+  graph_.erase(search_old);
+  return GraphStatus::kOk;
 }
 
 template <typename N, typename E>
 void gdwg::Graph<N, E>::Clear() {
-  graph_.clear();
+  fingerprint_ = 0;
+  if (!pool_) {
+    // Moved-from graphs have no pool of their own
+    graph_.clear();
+    predecessors_.clear();
+    return;
+  }
+
+  if constexpr (std::is_trivially_destructible<N>::value &&
+                std::is_trivially_destructible<E>::value) {
+    // Nothing stored needs destroying, so start over with empty containers without walking the
+    // old ones. Everything they held is freed with the pool below.
+    auto node_alloc = graph_.get_allocator();
+    auto predecessor_alloc = predecessors_.get_allocator();
+    new (&graph_) node_map(node_alloc);
+    new (&predecessors_) predecessor_map(predecessor_alloc);
+  } else {
+    graph_.clear();
+    // clear() would keep the bucket array, which lives in the pool
+    predecessors_ = predecessor_map(predecessors_.get_allocator());
+  }
+  // Hand the pool's chunks back in one go rather than keeping them for reuse
+  pool_->release();
 }
 
 template <typename N, typename E>
 bool gdwg::Graph<N, E>::IsNode(const N& val) {
-  auto search = find_if(graph_.begin(), graph_.end(),
-                        [&val](auto const& pair) { return (*pair.first == val); });
-  if (search == graph_.end()) {
-    return false;
-  }
-  return true;
+  return graph_.find(val) != graph_.end();
 }
 
 template <typename N, typename E>
 bool gdwg::Graph<N, E>::IsConnected(const N& src, const N& dst) {
-  try {
-    // Search graph for source node
-    auto search_src = find_if(graph_.begin(), graph_.end(),
-                              [&src](auto const& pair) { return *pair.first == src; });
-    // Search graph for dst node
-    auto search_dst = find_if(graph_.begin(), graph_.end(),
-                              [&dst](auto const& pair) { return *pair.first == dst; });
-    if (search_src == graph_.end() || search_dst == graph_.end()) {
-      throw std::runtime_error(
-          "Cannot call Graph::IsConnected if src or dst node don't exist in the graph");
-    }
-
-    // Search source node edge list for dst node
-    auto search_vec = find_if(search_src->second.begin(), search_src->second.end(),
-                              [&dst](auto const& pair) { return (std::get<0>(*pair) == dst); });
+  // A missing node has always been reported as connected, after the message
+  bool connected = true;
+  if (TryIsConnected(src, dst, connected) != GraphStatus::kOk) {
+    std::cout << "Cannot call Graph::IsConnected if src or dst node don't exist in the graph\n";
+  }
+  return connected;
+}
 
-    // If edge not found return false
-    if (search_vec == search_src->second.end()) {
-      return false;
-    }
-  } catch (const std::runtime_error& e) {
-    std::cout << e.what() << '\n';
+template <typename N, typename E>
+gdwg::GraphStatus
+gdwg::Graph<N, E>::TryIsConnected(const N& src, const N& dst, bool& connected) const {
+  auto search_src = graph_.find(src);
+  if (search_src == graph_.end()) {
+    return GraphStatus::kMissingSrc;
   }
-  return true;
+  if (graph_.find(dst) == graph_.end()) {
+    return GraphStatus::kMissingDst;
+  }
+  connected = search_src->second.find(dst) != search_src->second.end();
+  return GraphStatus::kOk;
 }
 
 template <typename N, typename E>
@@ -278,140 +492,418 @@ std::vector<N> gdwg::Graph<N, E>::GetNodes() {
 template <typename N, typename E>
 std::vector<N> gdwg::Graph<N, E>::GetConnected(const N& src) {
   std::vector<N> vec;
-  try {
-    // Search graph for source node
-    auto search_src = find_if(graph_.begin(), graph_.end(),
-                              [&src](auto const& pair) { return *pair.first == src; });
-    if (search_src == graph_.end()) {
-      throw std::out_of_range("Cannot call Graph::GetConnected if src doesn't exist in the graph");
-    }
-
-    for (auto it = search_src->second.begin(); it != search_src->second.end(); ++it) {
-      vec.emplace_back(std::get<0>(*(*it)));
-    }
-  } catch (const std::out_of_range& e) {
-    std::cout << e.what() << '\n';
+  if (TryGetConnected(src, vec) != GraphStatus::kOk) {
+    std::cout << "Cannot call Graph::GetConnected if src doesn't exist in the graph\n";
   }
   return vec;
 }
 
+template <typename N, typename E>
+gdwg::GraphStatus gdwg::Graph<N, E>::TryGetConnected(const N& src, std::vector<N>& out) const {
+  GDWG_OBSERVE(kGetConnected);
+  auto search_src = graph_.find(src);
+  if (search_src == graph_.end()) {
+    return GraphStatus::kMissingSrc;
+  }
+  out.clear();
+  for (const auto& edge : search_src->second) {
+    out.emplace_back(std::get<0>(*edge));
+  }
+  GDWG_VISIT(1, out.size());
+  return GraphStatus::kOk;
+}
+
 template <typename N, typename E>
 std::vector<E> gdwg::Graph<N, E>::GetWeights(const N& src, const N& dst) {
   std::vector<E> vec;
-  try {
-    // Search graph for source node
-    auto search_src = find_if(graph_.begin(), graph_.end(),
-                              [&src](auto const& pair) { return *pair.first == src; });
-    // Search graph for dst node
-    auto search_dst = find_if(graph_.begin(), graph_.end(),
-                              [&dst](auto const& pair) { return *pair.first == dst; });
-    if (search_src == graph_.end() || search_dst == graph_.end()) {
-      throw std::out_of_range(
-          "Cannot call Graph::GetWeights if src or dst node don't exist in the graph");
-    }
-
-    for (auto it = search_src->second.begin(); it != search_src->second.end(); ++it) {
-      if (std::get<0>(*(*it)) == dst) {
-        vec.emplace_back(std::get<1>(*(*it)));
+  if (TryGetWeights(src, dst, vec) != GraphStatus::kOk) {
+    std::cout << "Cannot call Graph::GetWeights if src or dst node don't exist in the graph\n";
+  }
+  return vec;
+}
+
+template <typename N, typename E>
+gdwg::GraphStatus
+gdwg::Graph<N, E>::TryGetWeights(const N& src, const N& dst, std::vector<E>& out) const {
+  GDWG_OBSERVE(kGetWeights);
+  auto search_src = graph_.find(src);
+  if (search_src == graph_.end()) {
+    return GraphStatus::kMissingSrc;
+  }
+  if (graph_.find(dst) == graph_.end()) {
+    return GraphStatus::kMissingDst;
+  }
+  out.clear();
+  auto range = search_src->second.equal_range(dst);
+  for (auto it = range.first; it != range.second; ++it) {
+    out.emplace_back(std::get<1>(**it));
+  }
+  GDWG_VISIT(2, out.size());
+  return GraphStatus::kOk;
+}
+
+template <typename N, typename E>
+std::vector<N> gdwg::Graph<N, E>::GetPredecessors(const N& dst) {
+  std::vector<N> vec;
+  if (TryGetPredecessors(dst, vec) != GraphStatus::kOk) {
+    std::cout << "Cannot call Graph::GetPredecessors if dst doesn't exist in the graph\n";
+  }
+  return vec;
+}
+
+template <typename N, typename E>
+gdwg::GraphStatus gdwg::Graph<N, E>::TryGetPredecessors(const N& dst, std::vector<N>& out) const {
+  auto search_dst = graph_.find(dst);
+  if (search_dst == graph_.end()) {
+    return GraphStatus::kMissingDst;
+  }
+  out.clear();
+  auto incoming = predecessors_.find(search_dst->first.get());
+  if (incoming != predecessors_.end()) {
+    for (const auto& pred : incoming->second) {
+      out.emplace_back(*pred.first);
+    }
+  }
+  std::sort(out.begin(), out.end());
+  return GraphStatus::kOk;
+}
+
+template <typename N, typename E>
+std::size_t gdwg::Graph<N, E>::Apply(const std::vector<Mutation>& batch) {
+  // Sort every mention of a node, so each distinct node is looked up once and ranked in node
+  // order. Mention 2 * i is the source of change i and mention 2 * i + 1 its destination.
+  std::vector<std::pair<const N*, std::size_t>> mentions;
+  mentions.reserve(batch.size() * 2);
+  for (std::size_t i = 0; i < batch.size(); ++i) {
+    mentions.emplace_back(&batch[i].src, 2 * i);
+    mentions.emplace_back(&batch[i].dst, 2 * i + 1);
+  }
+  std::sort(mentions.begin(), mentions.end(),
+            [](const auto& lhs, const auto& rhs) { return *lhs.first < *rhs.first; });
+
+  // Look the nodes up in order, creating the ones an insert needs
+  std::vector<typename node_map::iterator> nodes;
+  std::vector<std::size_t> ranks(mentions.size());
+  std::vector<std::uint64_t> hashes;
+  for (std::size_t i = 0; i < mentions.size();) {
+    const N& name = *mentions[i].first;
+    bool needed = false;
+    for (; i < mentions.size() && !(name < *mentions[i].first); ++i) {
+      needed = needed || batch[mentions[i].second / 2].op == Mutation::Op::kInsert;
+      ranks[mentions[i].second] = nodes.size();
+    }
+    hashes.push_back(HashNode(name));
+    auto search = graph_.lower_bound(name);
+    if (search == graph_.end() || name < *search->first) {
+      search = needed ? graph_.emplace_hint(search, MakeNode(name), MakeEdgeSet()) : graph_.end();
+      fingerprint_ += needed ? NodeTerm(hashes.back()) : 0;
+    }
+    nodes.push_back(search);
+  }
+
+  // Order the changes by (src, dst, weight), keeping the batch order of changes to one edge
+  std::vector<std::size_t> order(batch.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+    return std::tie(ranks[2 * lhs], ranks[2 * lhs + 1], batch[lhs].weight) <
+           std::tie(ranks[2 * rhs], ranks[2 * rhs + 1], batch[rhs].weight);
+  });
+
+  // Change each source's edges in order. The edges into each destination are counted as they
+  // change and predecessors_ is updated once per destination afterwards.
+  std::vector<std::tuple<std::size_t, const N*, int>> incoming;
+  for (auto i : order) {
+    auto src = nodes[ranks[2 * i]];
+    auto dst = nodes[ranks[2 * i + 1]];
+    if (src == graph_.end() || dst == graph_.end()) {
+      continue;
+    }
+    const auto& change = batch[i];
+    auto& edges = src->second;
+    auto key = edge_key{change.dst, change.weight};
+    auto search = edges.lower_bound(key);
+    bool exists = search != edges.end() && !setCompare{}(key, *search);
+    auto term = EdgeTerm(hashes[ranks[2 * i]], hashes[ranks[2 * i + 1]], change.weight);
+    if (change.op == Mutation::Op::kInsert && !exists) {
+      edges.emplace_hint(search, MakeEdge(*dst->first, change.weight));
+      incoming.emplace_back(ranks[2 * i + 1], src->first.get(), 1);
+      fingerprint_ += term;
+    } else if (change.op == Mutation::Op::kErase && exists) {
+      edges.erase(search);
+      incoming.emplace_back(ranks[2 * i + 1], src->first.get(), -1);
+      fingerprint_ -= term;
+    }
+  }
+  std::sort(incoming.begin(), incoming.end(), [](const auto& lhs, const auto& rhs) {
+    return std::tie(std::get<0>(lhs), std::get<1>(lhs)) <
+           std::tie(std::get<0>(rhs), std::get<1>(rhs));
+  });
+  for (std::size_t i = 0; i < incoming.size();) {
+    auto rank = std::get<0>(incoming[i]);
+    const N* dst = nodes[rank]->first.get();
+    auto& counts = predecessors_[dst];
+    while (i < incoming.size() && std::get<0>(incoming[i]) == rank) {
+      const N* src = std::get<1>(incoming[i]);
+      std::ptrdiff_t net = 0;
+      for (; i < incoming.size() && std::get<0>(incoming[i]) == rank &&
+             std::get<1>(incoming[i]) == src;
+           ++i) {
+        net += std::get<2>(incoming[i]);
       }
+      if (net != 0) {
+        auto& count = counts[src];
+        count = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(count) + net);
+        if (count == 0) {
+          counts.erase(src);
+        }
+      }
+    }
+    if (counts.empty()) {
+      predecessors_.erase(dst);
+    }
+  }
+  return incoming.size();
+}
+
+template <typename N, typename E>
+gdwg::CsrGraph<N, E> gdwg::Graph<N, E>::Freeze() const {
+  // Number the nodes in map order, which is sorted order, then copy values and weights out
+  detail::NodeIndex<node_map> index{graph_};
+  std::vector<N> nodes;
+  std::vector<E> weights;
+  nodes.reserve(index.nodes.size());
+  weights.reserve(index.targets.size());
+  for (const auto& it : index.nodes) {
+    nodes.push_back(*it->first);
+    for (const auto& edge : it->second) {
+      weights.push_back(std::get<1>(*edge));
+    }
+  }
+
+  return CsrGraph<N, E>{std::move(nodes), std::move(index.offsets), std::move(index.targets),
+                        std::move(weights)};
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::node_ptr gdwg::Graph<N, E>::MakeNode(const N& val) {
+  return MakePooled<N>(graph_.get_allocator().resource(), val);
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::edge_ptr gdwg::Graph<N, E>::MakeEdge(N& dst, const E& w) {
+  return MakePooled<std::tuple<N&, E>>(graph_.get_allocator().resource(), dst, w);
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::edge gdwg::Graph<N, E>::MakeEdgeSet() {
+  return edge{PoolAllocator<edge_ptr>{graph_.get_allocator().resource()}};
+}
+
+template <typename N, typename E>
+void gdwg::Graph<N, E>::LeaveEmpty() noexcept {
+  // The pool went with the moved containers, so allocate from the default resource from now on
+  PoolAllocator<char> allocator{std::pmr::new_delete_resource()};
+  graph_ = node_map(allocator);
+  predecessors_ = predecessor_map(typename predecessor_map::allocator_type{allocator});
+  fingerprint_ = 0;
+}
+
+template <typename N, typename E>
+std::uint64_t gdwg::Graph<N, E>::HashNode(const N& val) {
+  if constexpr (kHashable) {
+    return std::hash<N>{}(val);
+  } else {
+    return 0;
+  }
+}
+
+template <typename N, typename E>
+std::uint64_t gdwg::Graph<N, E>::NodeTerm(std::uint64_t node) {
+  return kHashable ? detail::MixHash(node) : 0;
+}
+
+template <typename N, typename E>
+std::uint64_t gdwg::Graph<N, E>::EdgeTerm(std::uint64_t src, std::uint64_t dst, const E& w) {
+  if constexpr (kHashable) {
+    // Chained rather than summed, so (a, b) and (b, a) differ
+    return detail::MixHash(detail::MixHash(detail::MixHash(src) ^ dst) ^ std::hash<E>{}(w));
+  } else {
+    return 0;
+  }
+}
+
+template <typename N, typename E>
+std::uint64_t gdwg::Graph<N, E>::TouchingTerms(typename node_map::const_iterator node) const {
+  if constexpr (!kHashable) {
+    return 0;
+  }
+  auto hash = HashNode(*node->first);
+  auto terms = NodeTerm(hash);
+  for (const auto& out : node->second) {
+    terms += EdgeTerm(hash, HashNode(std::get<0>(*out)), std::get<1>(*out));
+  }
+  auto incoming = predecessors_.find(node->first.get());
+  if (incoming != predecessors_.end()) {
+    for (const auto& pred : incoming->second) {
+      // Self loops were counted as out edges
+      if (pred.first == node->first.get()) {
+        continue;
+      }
+      auto src = HashNode(*pred.first);
+      const auto& edges = graph_.find(*pred.first)->second;
+      auto range = edges.equal_range(*node->first);
+      for (auto it = range.first; it != range.second; ++it) {
+        terms += EdgeTerm(src, hash, std::get<1>(*(*it)));
+      }
+    }
+  }
+  return terms;
+}
+
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::LinkEdge(typename node_map::iterator src, N& dst, const E& w) {
+  // lower_bound doubles as the insertion hint, so the edge set is only searched once
+  auto search = src->second.lower_bound(edge_key{dst, w});
+  if (search != src->second.end() && !setCompare{}(edge_key{dst, w}, *search)) {
+    return false;
+  }
+  src->second.emplace_hint(search, MakeEdge(dst, w));
+  ++predecessors_[&dst][src->first.get()];
+  fingerprint_ += EdgeTerm(HashNode(*src->first), HashNode(dst), w);
+  return true;
+}
+
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::edge::iterator
+gdwg::Graph<N, E>::UnlinkEdge(typename node_map::iterator src, typename edge::iterator it) {
+  const N& dst = std::get<0>(*(*it));
+  fingerprint_ -= EdgeTerm(HashNode(*src->first), HashNode(dst), std::get<1>(*(*it)));
+  UnlinkPredecessor(&dst, src->first.get());
+  return src->second.erase(it);
+}
+
+template <typename N, typename E>
+void gdwg::Graph<N, E>::UnlinkPredecessor(const N* dst, const N* src) {
+  auto incoming = predecessors_.find(dst);
+  auto count = incoming->second.find(src);
+  if (--count->second == 0) {
+    incoming->second.erase(count);
+    if (incoming->second.empty()) {
+      predecessors_.erase(incoming);
     }
-  } catch (const std::out_of_range& e) {
-    std::cout << e.what() << '\n';
   }
-  return vec;
 }
 
 template <typename N, typename E>
 typename gdwg::Graph<N, E>::const_iterator
 gdwg::Graph<N, E>::find(const N& src, const N& dst, const E& w) {
+  GDWG_OBSERVE(kFind);
   // Search graph for source node
-  auto search_src = find_if(graph_.begin(), graph_.end(),
-                            [&src](auto const& pair) { return *pair.first == src; });
+  auto search_src = graph_.find(src);
+  GDWG_VISIT(1, 0);
+  if (search_src == graph_.end()) {
+    return end();
+  }
   // Search source node edge list for dst node
-  auto search_vec =
-      find_if(search_src->second.begin(), search_src->second.end(), [&dst, &w](auto const& pair) {
-        return ((std::get<0>(*pair) == dst) && (std::get<1>(*pair) == w));
-      });
+  auto search_vec = search_src->second.find(edge_key{dst, w});
 
-  // Return end if edge or node not found
-  if (search_src == graph_.end() || search_vec == search_src->second.end()) {
+  // Return end if edge not found
+  if (search_vec == search_src->second.end()) {
     return end();
   }
 
   // Return iterator to edge
+  GDWG_VISIT(0, 1);
   return const_iterator{search_src, graph_.cbegin(), graph_.cend(), search_vec};
 }
 
 template <typename N, typename E>
 bool gdwg::Graph<N, E>::erase(const N& src, const N& dst, const E& w) {
-  // Search graph for source node
-  auto search_src = find_if(graph_.begin(), graph_.end(),
-                            [&src](auto const& pair) { return *pair.first == src; });
-  // Search source node edge list for dst node
-  auto search_vec =
-      find_if(search_src->second.begin(), search_src->second.end(), [&dst, &w](auto const& pair) {
-        return ((std::get<0>(*pair) == dst) && (std::get<1>(*pair) == w));
-      });
+  return TryErase(src, dst, w) == GraphStatus::kOk;
+}
 
-  // Return false if edge or node not found
-  if (search_src == graph_.end() || search_vec == search_src->second.end()) {
-    return false;
+template <typename N, typename E>
+gdwg::GraphStatus gdwg::Graph<N, E>::TryErase(const N& src, const N& dst, const E& w) {
+  auto search_src = graph_.find(src);
+  if (search_src == graph_.end()) {
+    return GraphStatus::kMissingSrc;
   }
-  search_src->second.erase(*search_vec);
-  return true;
+  auto search_vec = search_src->second.find(edge_key{dst, w});
+  if (search_vec == search_src->second.end()) {
+    // Only a failed erase pays for looking up dst
+    return graph_.find(dst) == graph_.end() ? GraphStatus::kMissingDst : GraphStatus::kMissingEdge;
+  }
+  UnlinkEdge(search_src, search_vec);
+  return GraphStatus::kOk;
 }
 
 template <typename N, typename E>
-typename gdwg::Graph<N, E>::const_iterator gdwg::Graph<N, E>::erase(const_iterator it) {
-  auto jt = it;
-  jt++;
-  if (erase(std::get<0>(*it), std::get<1>(*it), std::get<2>(*it))) {
-    return jt;
+std::vector<gdwg::GraphStatus> gdwg::Graph<N, E>::TryApply(const std::vector<Mutation>& batch) {
+  std::vector<GraphStatus> statuses;
+  statuses.reserve(batch.size());
+  for (const auto& change : batch) {
+    statuses.push_back(change.op == Mutation::Op::kInsert
+                           ? TryInsertEdge(change.src, change.dst, change.weight)
+                           : TryErase(change.src, change.dst, change.weight));
   }
-  return end();
+  return statuses;
 }
 
 template <typename N, typename E>
-gdwg::Graph<N, E>& gdwg::Graph<N, E>::operator=(const gdwg::Graph<N, E>& source) {
-  this->graph_.clear();
-
-  // Copy construct nodes
-  for (auto it = source.graph_.begin(); it != source.graph_.end(); it++) {
-    graph_[std::make_unique<N>(*(it->first))] = edge();
+typename gdwg::Graph<N, E>::const_iterator gdwg::Graph<N, E>::erase(const_iterator it) {
+  if (it == end()) {
+    return end();
   }
-
-  // Copy construct edges
-  for (auto it = source.graph_.begin(); it != source.graph_.end(); it++) {
-    if (it->second.size() != 0) {
-      for (auto iter = it->second.begin(); iter != it->second.end(); iter++) {
-        N node = std::get<0>(*(*iter));
-
-        // Find the destination node to be connected to
-        auto search = find_if(graph_.begin(), graph_.end(),
-                              [&node](auto const& pair) { return *pair.first == node; });
-        E value = std::get<1>(*(*iter));
-        graph_[std::make_unique<N>(*(it->first))].emplace(
-            std::make_unique<std::tuple<N&, E>>(std::forward_as_tuple(*search->first, value)));
-      }
+  // Erasing moves the later edges of a flat edge set, so continue from where erase left off.
+  // Erasing an empty range turns the node's const_iterator into an iterator.
+  auto src = graph_.erase(it.key_, it.key_);
+  auto next = UnlinkEdge(src, it.value_);
+  typename node_map::const_iterator key = src;
+  while (next == key->second.end()) {
+    if (++key == graph_.cend()) {
+      return end();
     }
+    next = key->second.begin();
   }
+  return const_iterator{key, graph_.cbegin(), graph_.cend(), next};
+}
+
+template <typename N, typename E>
+gdwg::Graph<N, E>& gdwg::Graph<N, E>::operator=(const gdwg::Graph<N, E>& source) {
+  // Copy then move, so self assignment is safe and a failed copy leaves this graph untouched
+  Graph<N, E> copy{source};
+  *this = std::move(copy);
   return *this;
 }
+
 template <typename N, typename E>
 gdwg::Graph<N, E>& gdwg::Graph<N, E>::operator=(gdwg::Graph<N, E>&& source) noexcept {
-  *this = source;
-  source.graph_.clear();
+  if (this == &source) {
+    return *this;
+  }
+
+  // Free what this graph holds, then take over the source's containers and the pool they use.
+  // PoolAllocator propagates on move assignment, so nothing is copied.
+  Clear();
+  graph_ = std::move(source.graph_);
+  predecessors_ = std::move(source.predecessors_);
+  pool_ = std::move(source.pool_);
+  fingerprint_ = source.fingerprint_;
+  source.LeaveEmpty();
 
   return *this;
 }
 
 template <typename N, typename E>
 typename gdwg::Graph<N, E>::const_iterator& gdwg::Graph<N, E>::const_iterator::operator++() {
+  GDWG_OBSERVE(kIterate);
   if (key_ != end_) {
+    GDWG_VISIT(0, 1);
     value_++;
     if (value_ == (key_->second).cend()) {
       key_++;
       while (key_ != end_) {
+        GDWG_VISIT(1, 0);
         if (!key_->second.empty()) {
           value_ = key_->second.begin();
           return *this;
@@ -425,18 +917,20 @@ typename gdwg::Graph<N, E>::const_iterator& gdwg::Graph<N, E>::const_iterator::o
 
 template <typename N, typename E>
 typename gdwg::Graph<N, E>::const_iterator& gdwg::Graph<N, E>::const_iterator::operator--() {
-  if (key_ != begin_) {
-    if (key_ == end_ || value_ == (key_->second).cbegin()) {
-      while (key_ != begin_) {
-        key_--;
-        if (!key_->second.empty()) {
-          value_ = key_->second.end();
-          value_--;
-          return *this;
-        }
-      }
-    } else {
+  GDWG_OBSERVE(kIterate);
+  GDWG_VISIT(0, 1);
+  // Within a node, including the first one
+  if (key_ != end_ && value_ != (key_->second).cbegin()) {
+    value_--;
+    return *this;
+  }
+  while (key_ != begin_) {
+    key_--;
+    GDWG_VISIT(1, 0);
+    if (!key_->second.empty()) {
+      value_ = key_->second.end();
       value_--;
+      return *this;
     }
   }
 
@@ -453,6 +947,71 @@ operator*() {
   return {node1, node2, edge};
 }
 
+template <typename N, typename E>
+typename gdwg::Graph<N, E>::edge_range gdwg::Graph<N, E>::Edges() const {
+  typename edge_range::iterator first{graph_.begin(), graph_.end(), {}};
+  if (!graph_.empty()) {
+    first.value_ = graph_.begin()->second.begin();
+    first.SkipEmpty();
+  }
+  return edge_range{first, typename edge_range::iterator{graph_.end(), graph_.end(), {}}};
+}
+
+template <typename N, typename E>
+std::size_t gdwg::Graph<N, E>::edge_range::size() const {
+  // Whole edge sets, less the edges before the first and plus those before the last
+  std::size_t total = 0;
+  for (auto key = first_.key_; key != last_.key_; ++key) {
+    total += key->second.size();
+  }
+  if (first_.key_ != first_.end_) {
+    total -= static_cast<std::size_t>(std::distance(first_.key_->second.begin(), first_.value_));
+  }
+  if (last_.key_ != last_.end_) {
+    total += static_cast<std::size_t>(std::distance(last_.key_->second.begin(), last_.value_));
+  }
+  return total;
+}
+
+template <typename N, typename E>
+std::vector<typename gdwg::Graph<N, E>::edge_range>
+gdwg::Graph<N, E>::edge_range::Split(std::size_t parts) const {
+  auto total = size();
+  parts = std::max<std::size_t>(1, std::min(parts, total));
+  std::vector<edge_range> result;
+  result.reserve(parts);
+
+  // Skip whole edge sets by their size where possible, stepping inside one only to reach a cut.
+  // offset is the position's index in its edge set.
+  auto position = first_;
+  std::size_t offset = 0;
+  if (position.key_ != position.end_) {
+    offset =
+        static_cast<std::size_t>(std::distance(position.key_->second.begin(), position.value_));
+  }
+  std::size_t passed = 0;
+  for (std::size_t part = 1; part < parts; ++part) {
+    auto from = position;
+    auto cut = total * part / parts;
+    while (passed < cut) {
+      auto left = position.key_->second.size() - offset;
+      if (passed + left <= cut) {
+        passed += left;
+        position.value_ = position.key_->second.end();
+        position.SkipEmpty();
+        offset = 0;
+      } else {
+        std::advance(position.value_, cut - passed);
+        offset += cut - passed;
+        passed = cut;
+      }
+    }
+    result.push_back(edge_range{from, position});
+  }
+  result.push_back(edge_range{position, last_});
+  return result;
+}
+
 template <typename N, typename E>
 typename gdwg::Graph<N, E>::const_iterator gdwg::Graph<N, E>::cbegin() const {
   for (auto it = graph_.cbegin(); it != graph_.cend(); ++it) {
@@ -0,0 +1,408 @@
+#include <malloc.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/bfs.h"
+#include "assignments/dg/components.h"
+#include "assignments/dg/concurrent_graph.h"
+#include "assignments/dg/edge_list.h"
+#include "assignments/dg/flat_graph.h"
+#include "assignments/dg/graph.h"
+#include "assignments/dg/graph_io.h"
+#include "assignments/dg/interned_graph.h"
+#include "assignments/dg/pagerank.h"
+#include "assignments/dg/parallel.h"
+#include "assignments/dg/shortest_paths.h"
+#include "assignments/dg/topological_sort.h"
+#include "assignments/dg/watched_graph.h"
+
+// Times the node lookup paths of gdwg::Graph. Usage: graph_benchmark [nodes] [edges per node]
+
+namespace {
+
+std::size_t allocations = 0;
+std::size_t allocated_bytes = 0;
+// Bytes currently allocated, as malloc counts them, so freed growth doesn't count
+std::size_t live_bytes = 0;
+
+// Runs f and prints how long it took and how many heap allocations it made per call
+template <typename F>
+void Time(const std::string& name, std::size_t calls, F f) {
+  auto allocated = allocations;
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto stop = std::chrono::steady_clock::now();
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+  std::cout << name << ": " << ns / 1e6 << " ms (" << static_cast<double>(ns) / calls
+            << " ns/call, " << static_cast<double>(allocations - allocated) / calls
+            << " allocations/call)\n";
+}
+
+// Fills a Graph<int, double> or FlatGraph<int, double> with the benchmark's edges and times how
+// quickly it fills and is walked, and how much memory it holds per edge
+template <typename G>
+void TimeIntGraph(const std::string& name,
+                  std::size_t nodes,
+                  const std::vector<std::size_t>& src,
+                  const std::vector<std::size_t>& dst,
+                  std::size_t& sink) {
+  auto live = live_bytes;
+  G g;
+  Time(name + " InsertNode", nodes, [&] {
+    for (std::size_t i = 0; i < nodes; ++i) {
+      sink += g.InsertNode(static_cast<int>(i));
+    }
+  });
+  Time(name + " InsertEdge", src.size(), [&] {
+    for (std::size_t i = 0; i < src.size(); ++i) {
+      sink += g.InsertEdge(static_cast<int>(src[i]), static_cast<int>(dst[i]),
+                           static_cast<double>(i));
+    }
+  });
+  std::cout << "  " << static_cast<double>(live_bytes - live) / src.size() << " bytes/edge\n";
+  Time(name + " IsConnected", src.size(), [&] {
+    for (std::size_t i = 0; i < src.size(); ++i) {
+      sink += g.IsConnected(static_cast<int>(src[i]), static_cast<int>(dst[i]));
+    }
+  });
+  Time(name + " iterate", src.size(), [&] {
+    for (const auto& [from, to, weight] : g) {
+      sink += static_cast<std::size_t>(weight);
+    }
+  });
+}
+
+}  // namespace
+
+// Count every heap allocation, including the aligned ones memory resources make. None of these
+// may be inlined, or GCC sees malloc paired with operator delete, or new with free, and warns.
+__attribute__((noinline)) void* operator new(std::size_t size) {
+  ++allocations;
+  allocated_bytes += size;
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    live_bytes += malloc_usable_size(p);
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+
+__attribute__((noinline)) void* operator new(std::size_t size, std::align_val_t align) {
+  ++allocations;
+  allocated_bytes += size;
+  auto alignment = static_cast<std::size_t>(align);
+  if (void* p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)) {
+    live_bytes += malloc_usable_size(p);
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+  live_bytes -= malloc_usable_size(p);
+  std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, std::size_t) noexcept {
+  live_bytes -= malloc_usable_size(p);
+  std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, std::align_val_t) noexcept {
+  live_bytes -= malloc_usable_size(p);
+  std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+  live_bytes -= malloc_usable_size(p);
+  std::free(p);
+}
+
+int main(int argc, char* argv[]) {
+  std::size_t nodes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+  std::size_t degree = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+
+  std::vector<std::string> names;
+  for (std::size_t i = 0; i < nodes; ++i) {
+    names.push_back("node" + std::to_string(i));
+  }
+  std::mt19937 rng{6771};
+  std::uniform_int_distribution<std::size_t> pick{0, nodes - 1};
+  std::vector<std::size_t> src;
+  std::vector<std::size_t> dst;
+  for (std::size_t i = 0; i < nodes * degree; ++i) {
+    src.push_back(pick(rng));
+    dst.push_back(pick(rng));
+  }
+
+  gdwg::Graph<std::string, int> g;
+  std::size_t sink = 0;
+
+  auto graph_bytes = allocated_bytes;
+  Time("InsertNode", nodes, [&] {
+    for (const auto& name : names) {
+      sink += g.InsertNode(name);
+    }
+  });
+  Time("InsertEdge", src.size(), [&] {
+    for (std::size_t i = 0; i < src.size(); ++i) {
+      sink += g.InsertEdge(names[src[i]], names[dst[i]], static_cast<int>(i));
+    }
+  });
+  // The graph's pool only asks for more memory as it grows, so this is its footprint
+  std::cout << "  " << static_cast<double>(allocated_bytes - graph_bytes) / src.size()
+            << " bytes/edge\n";
+  {
+    using change = gdwg::Graph<std::string, int>::Mutation;
+    std::vector<change> batch;
+    for (std::size_t i = 0; i < src.size(); ++i) {
+      batch.push_back({change::Op::kInsert, names[src[i]], names[dst[i]], static_cast<int>(i)});
+    }
+    gdwg::Graph<std::string, int> applied{names.begin(), names.end()};
+    Time("Apply", batch.size(), [&] { sink += applied.Apply(batch); });
+  }
+  {
+    gdwg::InternedGraph<std::string, int> interned;
+    std::vector<gdwg::NodeId> ids;
+    Time("interned Intern", nodes, [&] {
+      for (const auto& name : names) {
+        ids.push_back(interned.Intern(name));
+      }
+    });
+    Time("interned InsertEdge", src.size(), [&] {
+      for (std::size_t i = 0; i < src.size(); ++i) {
+        sink += interned.InsertEdge(ids[src[i]], ids[dst[i]], static_cast<int>(i));
+      }
+    });
+    Time("interned IsConnected", src.size(), [&] {
+      for (std::size_t i = 0; i < src.size(); ++i) {
+        sink += interned.IsConnected(ids[src[i]], ids[dst[i]]);
+      }
+    });
+    Time("interned iterate", src.size(), [&] {
+      for (auto id : ids) {
+        for (auto weight : interned.Weights(id)) {
+          sink += static_cast<std::size_t>(weight);
+        }
+      }
+    });
+  }
+  // The same edges over int nodes, in Graph's pointer-based storage and FlatGraph's arrays
+  TimeIntGraph<gdwg::Graph<int, double>>("int Graph", nodes, src, dst, sink);
+  TimeIntGraph<gdwg::CompactGraph<int, double>>("int FlatGraph", nodes, src, dst, sink);
+  {
+    // The same edges pointed from the lower id to the higher, so they form a DAG
+    std::vector<std::tuple<std::string, std::string, int>> forward;
+    for (std::size_t i = 0; i < src.size(); ++i) {
+      if (src[i] != dst[i]) {
+        auto [from, to] = std::minmax(src[i], dst[i]);
+        forward.emplace_back(names[from], names[to], static_cast<int>(i % 100));
+      }
+    }
+    auto dag = gdwg::Graph<std::string, int>::BulkLoad(forward.begin(), forward.end());
+    Time("TopologicalSort", nodes, [&] { sink += gdwg::TopologicalSort(dag).size(); });
+    Time("TopologicalSort all threads", nodes,
+         [&] { sink += gdwg::TopologicalSort(dag, {0}).size(); });
+    Time("FindCycle", nodes, [&] { sink += gdwg::FindCycle(dag).size(); });
+    Time("LongestPath", nodes, [&] { sink += gdwg::LongestPath(dag).nodes.size(); });
+  }
+  std::vector<std::tuple<std::string, std::string, int>> tuples;
+  for (std::size_t i = 0; i < src.size(); ++i) {
+    tuples.emplace_back(names[src[i]], names[dst[i]], static_cast<int>(i));
+  }
+  gdwg::Graph<std::string, int> bulk;
+  Time("BulkLoad", tuples.size(), [&] {
+    bulk = gdwg::Graph<std::string, int>::BulkLoad(std::make_move_iterator(tuples.begin()),
+                                                    std::make_move_iterator(tuples.end()));
+  });
+  sink += bulk.GetNodes().size();
+  bulk.Clear();
+  std::string text;
+  for (std::size_t i = 0; i < src.size(); ++i) {
+    text += names[src[i]] + ' ' + names[dst[i]] + ' ' + std::to_string(i) + '\n';
+  }
+  gdwg::EdgeListStats stats;
+  Time("LoadEdgeList", src.size(), [&] {
+    std::istringstream in{std::move(text)};
+    sink += gdwg::LoadEdgeList<int>(in, {}, &stats).GetNodes().size();
+  });
+  std::cout << "  " << stats.MegabytesPerSecond() << " MB/s, " << stats.parse_seconds * 1e3
+            << " ms parsing\n";
+  Time("IsNode", nodes, [&] {
+    for (const auto& name : names) {
+      sink += g.IsNode(name);
+    }
+  });
+  Time("IsConnected", src.size(), [&] {
+    for (std::size_t i = 0; i < src.size(); ++i) {
+      sink += g.IsConnected(names[src[i]], names[dst[i]]);
+    }
+  });
+  Time("GetWeights", src.size(), [&] {
+    for (std::size_t i = 0; i < src.size(); ++i) {
+      sink += g.GetWeights(names[src[i]], names[dst[i]]).size();
+    }
+  });
+  Time("find", src.size(), [&] {
+    for (std::size_t i = 0; i < src.size(); ++i) {
+      sink += g.find(names[src[i]], names[dst[i]], static_cast<int>(i)) != g.end();
+    }
+  });
+  Time("iterate", src.size(), [&] {
+    for (const auto& [from, to, weight] : g) {
+      sink += static_cast<std::size_t>(weight);
+    }
+  });
+  Time("iterate Edges", src.size(), [&] {
+    auto edges = g.Edges();
+    for (auto it = edges.begin(); it != edges.end(); ++it) {
+      sink += it.Weight();
+    }
+  });
+  Time("parallel Edges scan", src.size(), [&] {
+    auto parts = g.Edges().Split(gdwg::DefaultThreads());
+    std::vector<long long> sums(parts.size());
+    gdwg::ParallelFor(parts.size(), parts.size(),
+                      [&](std::size_t begin, std::size_t end, std::size_t) {
+                        for (auto i = begin; i < end; ++i) {
+                          for (auto it = parts[i].begin(); it != parts[i].end(); ++it) {
+                            sums[i] += it.Weight();
+                          }
+                        }
+                      });
+    for (auto sum : sums) {
+      sink += sum;
+    }
+  });
+  gdwg::CsrGraph<std::string, int> frozen;
+  Time("Freeze", src.size(), [&] { frozen = g.Freeze(); });
+  Time("iterate frozen", src.size(), [&] {
+    for (const auto& [from, to, weight] : frozen) {
+      sink += static_cast<std::size_t>(weight);
+    }
+  });
+  const std::string path = "graph_benchmark.bin";
+  Time("Save", src.size(), [&] {
+    std::ofstream out{path, std::ios::binary};
+    gdwg::Save(frozen, out);
+  });
+  {
+    std::unique_ptr<gdwg::MappedGraph<std::string, int>> mapped;
+    Time("MappedGraph", 1, [&] {
+      mapped = std::make_unique<gdwg::MappedGraph<std::string, int>>(path);
+    });
+    Time("mapped IsConnected", src.size(), [&] {
+      for (std::size_t i = 0; i < src.size(); ++i) {
+        sink += mapped->IsConnected(names[src[i]], names[dst[i]]);
+      }
+    });
+    Time("mapped ToGraph", src.size(), [&] { sink += mapped->ToGraph().GetNodes().size(); });
+  }
+  std::remove(path.c_str());
+  gdwg::BfsResult bfs;
+  Time("BreadthFirstSearch", src.size(), [&] { bfs = gdwg::BreadthFirstSearch(frozen, 0); });
+  for (std::size_t depth = 0; depth < bfs.levels.size(); ++depth) {
+    const auto& level = bfs.levels[depth];
+    std::cout << "  level " << depth << ": " << level.frontier << " nodes, "
+              << (level.bottom_up ? "bottom-up" : "top-down") << ", " << level.milliseconds
+              << " ms\n";
+  }
+  for (std::size_t threads = 1; threads <= 32; threads *= 2) {
+    Time("WeaklyConnectedComponents, " + std::to_string(threads) + " threads", src.size(),
+         [&] { sink += gdwg::WeaklyConnectedComponents(frozen, {threads}).count; });
+  }
+  Time("StronglyConnectedComponents", src.size(),
+       [&] { sink += gdwg::StronglyConnectedComponents(frozen).count; });
+  for (std::size_t threads = 1; threads <= 4; threads *= 2) {
+    gdwg::PageRankOptions options;
+    options.threads = threads;
+    gdwg::PageRankResult ranks;
+    Time("PageRank, " + std::to_string(threads) + " threads", src.size(),
+         [&] { ranks = gdwg::PageRank(frozen, options); });
+    std::cout << "  " << ranks.iterations << " iterations, " << ranks.IterationsPerSecond()
+              << " iterations/s, " << ranks.GigabytesPerSecond() << " GB/s\n";
+  }
+  Time("Dijkstra", src.size(), [&] { sink += gdwg::Dijkstra(g, names[0]).distance.size(); });
+  Time("BellmanFord", src.size(), [&] { sink += gdwg::BellmanFord(g, names[0]).distance.size(); });
+  {
+    gdwg::WatchedGraph<std::string, int> watched{g};
+    Time("WatchedGraph Watch", src.size(), [&] { sink += watched.Watch(names[0]); });
+    // Reversed edges with small weights, so some of them shorten paths, then the original edges
+    const std::size_t updates = std::min<std::size_t>(1000, src.size());
+    std::size_t visited = 0;
+    Time("WatchedGraph InsertEdge", updates, [&] {
+      for (std::size_t i = 0; i < updates; ++i) {
+        sink += watched.InsertEdge(names[dst[i]], names[src[i]], static_cast<int>(i % 100));
+        visited += watched.LastUpdateCost();
+      }
+    });
+    std::cout << "  " << static_cast<double>(visited) / updates << " nodes visited per call\n";
+    visited = 0;
+    Time("WatchedGraph erase", updates, [&] {
+      for (std::size_t i = 0; i < updates; ++i) {
+        sink += watched.erase(names[src[i]], names[dst[i]], static_cast<int>(i));
+        visited += watched.LastUpdateCost();
+      }
+    });
+    std::cout << "  " << static_cast<double>(visited) / updates << " nodes visited per call\n";
+  }
+  gdwg::Graph<std::string, int> copy;
+  Time("copy", src.size(), [&] { copy = g; });
+  Time("move", 1, [&] {
+    gdwg::Graph<std::string, int> moved{std::move(copy)};
+    copy = std::move(moved);
+  });
+  Time("operator== equal", src.size(), [&] { sink += copy == g; });
+  // Change the graph at the end of its node order, where a walk finds the difference last
+  auto last = copy.GetNodes().back();
+  copy.InsertEdge(last, last, -1);
+  Time("operator== changed", 1, [&] { sink += copy == g; });
+  copy.erase(last, last, -1);
+  {
+    gdwg::ConcurrentGraph<std::string, int> shared{std::move(copy)};
+    Time("ConcurrentGraph Read", nodes, [&] {
+      for (std::size_t i = 0; i < nodes; ++i) {
+        auto view = shared.Read();
+        sink += view->NodeCount();
+      }
+    });
+    Time("ConcurrentGraph Commit", 1, [&] {
+      shared.Commit([&names](gdwg::Graph<std::string, int>& writer) {
+        writer.InsertEdge(names[0], names[1], -1);
+      });
+    });
+  }
+  Time("DeleteNode", nodes / 2, [&] {
+    for (std::size_t i = 0; i < nodes / 2; ++i) {
+      sink += g.DeleteNode(names[i]);
+    }
+  });
+  Time("erase", src.size(), [&] {
+    for (std::size_t i = 0; i < src.size(); ++i) {
+      sink += g.erase(names[src[i]], names[dst[i]], static_cast<int>(i));
+    }
+  });
+
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  std::cout << "peak RSS: " << usage.ru_maxrss / 1024 << " MiB\n";
+  std::cout << "checksum: " << sink << '\n';
+  // Built with -DGDWG_INSTRUMENT=1, also dump what every Graph operation above cost
+  if (gdwg::kInstrumented) {
+    gdwg::WritePrometheus(std::cout, gdwg::Instrumentation());
+  }
+}
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/generators.h"
+#include "assignments/dg/graph.h"
+
+// Times every Graph mutator and traversal over synthetic graphs and prints the results as JSON,
+// one record per generator, node type, size and operation.
+// Usage: graph_benchmark_suite [max edges] > results.json
+// Sizes run from 1e3 edges up by factors of 10 to max edges (default 1e6, 1e7 takes minutes).
+// Progress goes to stderr.
+
+namespace {
+
+// Node value for an id. Strings get a common prefix, so comparisons look past the first bytes.
+template <typename N>
+N Name(std::size_t id);
+template <>
+int Name<int>(std::size_t id) {
+  return static_cast<int>(id);
+}
+template <>
+std::string Name<std::string>(std::size_t id) {
+  return "node" + std::to_string(id);
+}
+
+template <typename N>
+const char* TypeName();
+template <>
+const char* TypeName<int>() {
+  return "int";
+}
+template <>
+const char* TypeName<std::string>() {
+  return "string";
+}
+
+// Whether no record has been printed yet, so the next one needs no separating comma
+bool first_record = true;
+
+// Prints one JSON record per operation timed over one graph
+class Report {
+ public:
+  Report(std::string generator, const char* node_type, std::size_t nodes, std::size_t edges)
+    : generator_{std::move(generator)}, node_type_{node_type}, nodes_{nodes}, edges_{edges} {}
+
+  // Runs f, which makes calls calls of operation, and records how long it took
+  template <typename F>
+  void Time(const char* operation, std::size_t calls, F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto stop = std::chrono::steady_clock::now();
+    auto seconds = std::chrono::duration<double>(stop - start).count();
+    std::cerr << generator_ << ' ' << node_type_ << ' ' << edges_ << ' ' << operation << ": "
+              << seconds * 1e3 << " ms\n";
+    if (!first_record) {
+      std::cout << ",\n";
+    }
+    first_record = false;
+    std::cout << "  {\"generator\": \"" << generator_ << "\", \"node_type\": \"" << node_type_
+              << "\", \"nodes\": " << nodes_ << ", \"edges\": " << edges_
+              << ", \"operation\": \"" << operation << "\", \"calls\": " << calls
+              << ", \"seconds\": " << seconds
+              << ", \"ns_per_call\": " << (calls > 0 ? seconds * 1e9 / calls : 0) << "}";
+  }
+
+ private:
+  std::string generator_;
+  const char* node_type_;
+  std::size_t nodes_;
+  std::size_t edges_;
+};
+
+template <typename N>
+void Run(const std::string& generator, const gdwg::GeneratedGraph& generated, std::size_t& sink) {
+  const auto& edges = generated.edges;
+  std::vector<N> names;
+  names.reserve(generated.nodes);
+  for (std::size_t i = 0; i < generated.nodes; ++i) {
+    names.push_back(Name<N>(i));
+  }
+  Report report{generator, TypeName<N>(), generated.nodes, edges.size()};
+
+  gdwg::Graph<N, int> g;
+  report.Time("InsertNode", names.size(), [&] {
+    for (const auto& name : names) {
+      sink += g.InsertNode(name);
+    }
+  });
+  report.Time("InsertEdge", edges.size(), [&] {
+    for (const auto& [src, dst, w] : edges) {
+      sink += g.InsertEdge(names[src], names[dst], w);
+    }
+  });
+  report.Time("GetWeights", edges.size(), [&] {
+    for (const auto& [src, dst, w] : edges) {
+      sink += g.GetWeights(names[src], names[dst]).size();
+    }
+  });
+  report.Time("find", edges.size(), [&] {
+    for (const auto& [src, dst, w] : edges) {
+      sink += g.find(names[src], names[dst], w) != g.end();
+    }
+  });
+  report.Time("iterate", edges.size(), [&] {
+    for (const auto& [src, dst, w] : g) {
+      sink += static_cast<std::size_t>(w);
+    }
+  });
+  gdwg::Graph<N, int> copy;
+  report.Time("copy", edges.size(), [&] { copy = g; });
+  report.Time("operator==", edges.size(), [&] { sink += copy == g; });
+
+  // Every distinct edge is erased from a copy of its own, so each call removes an edge
+  auto distinct = edges;
+  std::sort(distinct.begin(), distinct.end());
+  distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+  gdwg::Graph<N, int> erased{g};
+  report.Time("erase", distinct.size(), [&] {
+    for (const auto& [src, dst, w] : distinct) {
+      sink += erased.erase(names[src], names[dst], w);
+    }
+  });
+
+  // The rest change the graphs. A tenth of the nodes are renamed to new values, a hundredth
+  // merged into their neighbour by id and another tenth deleted.
+  const std::size_t renamed = std::max<std::size_t>(1, names.size() / 10);
+  report.Time("Replace", renamed, [&] {
+    for (std::size_t i = 0; i < renamed; ++i) {
+      sink += copy.Replace(names[i], Name<N>(names.size() + i));
+    }
+  });
+  // Each node is merged into the one merged ids on, so small graphs have fewer to merge
+  const std::size_t merged = std::max<std::size_t>(1, names.size() / 100);
+  const std::size_t merge_end =
+      std::min(renamed + merged, names.size() > merged ? names.size() - merged : 0);
+  report.Time("MergeReplace", merge_end > renamed ? merge_end - renamed : 0, [&] {
+    for (std::size_t i = renamed; i < merge_end; ++i) {
+      copy.MergeReplace(names[i], names[i + merged]);
+    }
+  });
+  report.Time("DeleteNode", renamed, [&] {
+    for (std::size_t i = renamed; i < 2 * renamed && i < names.size(); ++i) {
+      sink += g.DeleteNode(names[i]);
+    }
+  });
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::size_t max_edges = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  // Average out-degree of the random graphs. Grids have 4.
+  constexpr std::size_t degree = 8;
+  std::size_t sink = 0;
+
+  std::cout << "[\n";
+  for (std::size_t edges = 1000; edges <= max_edges; edges *= 10) {
+    auto side = static_cast<std::size_t>(std::sqrt(static_cast<double>(edges) / 4));
+    std::vector<std::pair<std::string, gdwg::GeneratedGraph>> graphs;
+    graphs.emplace_back("erdos_renyi", gdwg::ErdosRenyi(edges / degree, edges));
+    graphs.emplace_back("power_law", gdwg::PowerLaw(edges / degree, edges));
+    graphs.emplace_back("grid", gdwg::Grid(side, side));
+    for (const auto& [generator, generated] : graphs) {
+      Run<int>(generator, generated, sink);
+      Run<std::string>(generator, generated, sink);
+    }
+  }
+  std::cout << "\n]\n";
+  std::cerr << "checksum: " << sink << '\n';
+}
@@ -0,0 +1,48 @@
+#ifndef ASSIGNMENTS_DG_GRAPH_EXPORT_H_
+#define ASSIGNMENTS_DG_GRAPH_EXPORT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "assignments/dg/graph.h"
+
+namespace gdwg {
+
+enum class ExportFormat : std::uint8_t {
+  // "src dst weight" lines, as LoadEdgeList reads. Nodes without edges can't be written, and
+  // values must not contain blanks or line breaks.
+  kEdgeList,
+  // A Graphviz digraph, with every node named in quotes and the weights as edge labels
+  kDot,
+  // One JSON object per line, in node order: {"src": ..., "dst": ..., "weight": ...} for each
+  // edge, or {"node": ...} for a node without edges. Numbers are written bare, anything else
+  // as a string.
+  kJsonLines,
+};
+
+struct ExportOptions {
+  ExportFormat format = ExportFormat::kEdgeList;
+  // Threads formatting chunks of nodes side by side. 0 uses one per hardware thread.
+  std::size_t threads = 1;
+  // About how many bytes of text each thread formats before it is written out
+  std::size_t chunk_bytes = std::size_t{4} << 20;
+};
+
+// Writes the graph as text in node then edge order and returns the bytes written.
+// Numbers are formatted with std::to_chars and strings copied as they are, and other types go
+// through operator<<. Text is built in large buffers, one per thread, and each is handed to
+// the stream or file descriptor in a single write, in order, so the output doesn't depend on
+// the number of threads.
+// The stream version sets no error of its own; check the stream afterwards. The file
+// descriptor version throws std::system_error if a write fails.
+template <typename N, typename E>
+std::size_t Export(const Graph<N, E>& g, std::ostream& os, const ExportOptions& options = {});
+template <typename N, typename E>
+std::size_t Export(const Graph<N, E>& g, int fd, const ExportOptions& options = {});
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_GRAPH_EXPORT_H_
+
+#include "assignments/dg/graph_export.tpp"
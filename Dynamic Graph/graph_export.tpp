@@ -0,0 +1,239 @@
+#ifndef ASSIGNMENTS_DG_GRAPH_EXPORT_TPP_
+#define ASSIGNMENTS_DG_GRAPH_EXPORT_TPP_
+
+#include "assignments/dg/graph_export.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/parallel.h"
+
+namespace gdwg {
+namespace detail {
+
+// Types written with std::to_chars. bool and char print as words and characters instead.
+template <typename T>
+constexpr bool kIsNumber = std::is_arithmetic_v<T> && !std::is_same_v<T, bool> &&
+                           !std::is_same_v<T, char>;
+
+template <typename T>
+void AppendText(std::string& out, const T& value) {
+  if constexpr (kIsNumber<T>) {
+    char buffer[64];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+  } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+    out.append(std::string_view{value});
+  } else {
+    std::ostringstream text;
+    text << value;
+    out += text.str();
+  }
+}
+
+// Escapes quotes, backslashes and control characters in out from position from on
+inline void EscapeTail(std::string& out, std::size_t from) {
+  auto special = [](unsigned char c) { return c == '"' || c == '\\' || c < 0x20; };
+  // Most text needs no escaping, so the tail is only rebuilt when some does
+  if (std::none_of(out.begin() + static_cast<std::ptrdiff_t>(from), out.end(), special)) {
+    return;
+  }
+  std::string raw = out.substr(from);
+  out.resize(from);
+  for (unsigned char c : raw) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += static_cast<char>(c);
+    } else if (c == '\n') {
+      out += "\\n";
+    } else if (c < 0x20) {
+      char code[8];
+      std::snprintf(code, sizeof(code), "\\u%04x", c);
+      out += code;
+    } else {
+      out += static_cast<char>(c);
+    }
+  }
+}
+
+template <typename T>
+void AppendQuoted(std::string& out, const T& value) {
+  out += '"';
+  auto from = out.size();
+  AppendText(out, value);
+  EscapeTail(out, from);
+  out += '"';
+}
+
+// JSON has no infinities or NaN, so those are written as strings
+template <typename T>
+void AppendJson(std::string& out, const T& value) {
+  if constexpr (std::is_floating_point_v<T>) {
+    if (!std::isfinite(value)) {
+      AppendQuoted(out, value);
+      return;
+    }
+  }
+  if constexpr (kIsNumber<T>) {
+    AppendText(out, value);
+  } else {
+    AppendQuoted(out, value);
+  }
+}
+
+// Appends the text of the nodes in [first, last) and their edges
+template <typename N, typename E, typename It>
+void FormatNodes(It first, It last, ExportFormat format, std::string& out) {
+  // A node's text is built once and copied for each of its edges
+  std::string src;
+  // The ends and weights of a node's edges. Collecting them before formatting any lets the
+  // loads of scattered edges overlap instead of waiting on each in turn.
+  std::vector<std::pair<const N*, const E*>> edges;
+  for (auto it = first; it != last; ++it) {
+    src.clear();
+    edges.clear();
+    for (const auto& edge : it->second) {
+      edges.emplace_back(&std::get<0>(*edge), &std::get<1>(*edge));
+    }
+    switch (format) {
+      case ExportFormat::kEdgeList:
+        AppendText(src, *it->first);
+        for (const auto& [dst, weight] : edges) {
+          out += src;
+          out += ' ';
+          AppendText(out, *dst);
+          out += ' ';
+          AppendText(out, *weight);
+          out += '\n';
+        }
+        break;
+      case ExportFormat::kDot:
+        AppendQuoted(src, *it->first);
+        out += "  ";
+        out += src;
+        out += ";\n";
+        for (const auto& [dst, weight] : edges) {
+          out += "  ";
+          out += src;
+          out += " -> ";
+          AppendQuoted(out, *dst);
+          out += " [label=";
+          AppendQuoted(out, *weight);
+          out += "];\n";
+        }
+        break;
+      case ExportFormat::kJsonLines:
+        AppendJson(src, *it->first);
+        if (edges.empty()) {
+          out += "{\"node\": ";
+          out += src;
+          out += "}\n";
+        }
+        for (const auto& [dst, weight] : edges) {
+          out += "{\"src\": ";
+          out += src;
+          out += ", \"dst\": ";
+          AppendJson(out, *dst);
+          out += ", \"weight\": ";
+          AppendJson(out, *weight);
+          out += "}\n";
+        }
+        break;
+    }
+  }
+}
+
+// Formats the graph in chunks of nodes, a round of one chunk per thread at a time, and passes
+// each chunk's text to write(const std::string&) in node order
+template <typename N, typename E, typename Write>
+std::size_t ExportTo(const Graph<N, E>& g, const ExportOptions& options, Write write) {
+  const auto& adjacency = g.Adjacency();
+  const std::size_t threads = options.threads == 0 ? DefaultThreads() : options.threads;
+
+  // Cut after the node where a chunk's lines, at a guess of 24 bytes each, fill chunk_bytes
+  const std::size_t chunk_lines = std::max<std::size_t>(1, options.chunk_bytes / 24);
+  std::vector<typename std::decay_t<decltype(adjacency)>::const_iterator> cuts{adjacency.begin()};
+  std::size_t lines = 0;
+  for (auto it = adjacency.begin(); it != adjacency.end(); ++it) {
+    lines += std::max<std::size_t>(1, it->second.size());
+    if (lines >= chunk_lines) {
+      cuts.push_back(std::next(it));
+      lines = 0;
+    }
+  }
+  if (cuts.back() != adjacency.end()) {
+    cuts.push_back(adjacency.end());
+  }
+  const std::size_t chunks = cuts.size() - 1;
+
+  std::size_t bytes = 0;
+  std::string text;
+  if (options.format == ExportFormat::kDot) {
+    text = "digraph {\n";
+    bytes += text.size();
+    write(text);
+  }
+  std::vector<std::string> buffers(std::max<std::size_t>(1, std::min(threads, chunks)));
+  for (std::size_t round = 0; round < chunks; round += buffers.size()) {
+    const std::size_t count = std::min(buffers.size(), chunks - round);
+    ParallelFor(count, count, [&](std::size_t, std::size_t, std::size_t t) {
+      buffers[t].clear();
+      FormatNodes<N, E>(cuts[round + t], cuts[round + t + 1], options.format, buffers[t]);
+    });
+    for (std::size_t t = 0; t < count; ++t) {
+      bytes += buffers[t].size();
+      write(buffers[t]);
+    }
+  }
+  if (options.format == ExportFormat::kDot) {
+    text = "}\n";
+    bytes += text.size();
+    write(text);
+  }
+  return bytes;
+}
+
+}  // namespace detail
+}  // namespace gdwg
+
+template <typename N, typename E>
+std::size_t gdwg::Export(const Graph<N, E>& g, std::ostream& os, const ExportOptions& options) {
+  return detail::ExportTo(g, options, [&os](const std::string& text) {
+    os.write(text.data(), static_cast<std::streamsize>(text.size()));
+  });
+}
+
+template <typename N, typename E>
+std::size_t gdwg::Export(const Graph<N, E>& g, int fd, const ExportOptions& options) {
+  return detail::ExportTo(g, options, [fd](const std::string& text) {
+    const char* data = text.data();
+    std::size_t left = text.size();
+    while (left > 0) {
+      auto written = ::write(fd, data, left);
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        throw std::system_error(errno, std::generic_category(),
+                                "Cannot call gdwg::Export when the file can't be written");
+      }
+      data += written;
+      left -= static_cast<std::size_t>(written);
+    }
+  });
+}
+
+#endif
@@ -0,0 +1,212 @@
+#ifndef ASSIGNMENTS_DG_GRAPH_IO_H_
+#define ASSIGNMENTS_DG_GRAPH_IO_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "assignments/dg/csr_graph.h"
+#include "assignments/dg/graph.h"
+
+namespace gdwg {
+
+// Binary graph file, version 1. Integers are in host byte order and every section starts on a
+// 16 byte boundary, so a mapped file can be read in place.
+//   FileHeader
+//   node table     NodeCount() values, in sorted order
+//   offsets        NodeCount() + 1 uint64_t, as CsrGraph::Offsets()
+//   targets        EdgeCount() uint32_t, as CsrGraph::Targets()
+//   weight table   EdgeCount() values, as CsrGraph::Weights()
+// A table of trivially copyable values holds their bytes. A table of strings holds count + 1
+// uint64_t offsets into the characters that follow them.
+struct FileHeader {
+  // "GDWG" on a little endian machine. A file from a machine of the other byte order won't match.
+  static constexpr std::uint32_t kMagic = 0x47574447;
+  static constexpr std::uint32_t kVersion = 1;
+
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint32_t node_encoding;
+  std::uint32_t node_size;
+  std::uint32_t weight_encoding;
+  std::uint32_t weight_size;
+  std::uint64_t node_count;
+  std::uint64_t edge_count;
+  std::uint64_t nodes_offset;
+  std::uint64_t offsets_offset;
+  std::uint64_t targets_offset;
+  std::uint64_t weights_offset;
+  std::uint64_t file_size;
+};
+
+namespace detail {
+
+// How one table of values is written and read back in place. Only trivially copyable types
+// and std::string are supported.
+template <typename T, typename = void>
+struct BinaryTable;
+
+template <typename T>
+struct BinaryTable<T, std::enable_if_t<std::is_trivially_copyable_v<T>>> {
+  static constexpr std::uint32_t encoding = 1;
+  using view = const T&;
+
+  static std::uint64_t Bytes(const std::vector<T>& values) { return values.size() * sizeof(T); }
+  static void Write(std::ostream& os, const std::vector<T>& values);
+  // One value on its own, as in a delta log record
+  static void Append(std::string& out, const T& value);
+  static bool Read(const char*& p, const char* end, T& value);
+
+  // Values are used straight from the mapping
+  const T* data = nullptr;
+  bool Bind(const char* begin, const char* end, std::uint64_t count);
+  // Every value of a bound table is in bounds
+  bool Verify(std::uint64_t) const { return true; }
+  view operator[](std::size_t i) const { return data[i]; }
+};
+
+template <>
+struct BinaryTable<std::string> {
+  static constexpr std::uint32_t encoding = 2;
+  using view = std::string_view;
+
+  static std::uint64_t Bytes(const std::vector<std::string>& values);
+  static void Write(std::ostream& os, const std::vector<std::string>& values);
+  // One value on its own, as its uint64_t length then its characters
+  static void Append(std::string& out, const std::string& value);
+  static bool Read(const char*& p, const char* end, std::string& value);
+
+  const std::uint64_t* offsets = nullptr;
+  const char* chars = nullptr;
+  // Checks only the first and last offsets, so binding doesn't read the whole table
+  bool Bind(const char* begin, const char* end, std::uint64_t count);
+  // Whether the offsets in between never decrease, so every value is in bounds
+  bool Verify(std::uint64_t count) const;
+  view operator[](std::size_t i) const {
+    return view{chars + offsets[i], static_cast<std::size_t>(offsets[i + 1] - offsets[i])};
+  }
+};
+
+}  // namespace detail
+
+// Writes a graph in the binary format above. Throws std::runtime_error if the stream fails.
+template <typename N, typename E>
+void Save(const CsrGraph<N, E>& g, std::ostream& os);
+template <typename N, typename E>
+void Save(const Graph<N, E>& g, std::ostream& os);
+
+// Read-only graph served straight from a memory mapped binary file, so opening one costs
+// the same however large it is. Nodes and weights are returned as views into the mapping:
+// references for trivially copyable types and std::string_view for strings.
+// ToCsrGraph() and ToGraph() copy the whole file into an ordinary graph.
+// Opening a file checks its header and the bounds of each section, but not the offsets and
+// targets inside them, so a corrupt file can make queries read outside the mapping. Only open
+// trusted files, or call Verify() before the first query.
+template <typename N, typename E>
+class MappedGraph {
+ public:
+  using node_id = std::uint32_t;
+  using node_view = typename detail::BinaryTable<N>::view;
+  using weight_view = typename detail::BinaryTable<E>::view;
+  static constexpr node_id npos = std::numeric_limits<node_id>::max();
+
+  // Constructors
+  // Throws std::runtime_error if the file can't be mapped, isn't a version 1 graph file or
+  // was written with different node or weight types
+  explicit MappedGraph(const std::string& path);
+  MappedGraph(MappedGraph&& other) noexcept;
+  MappedGraph(const MappedGraph&) = delete;
+
+  // Destructor
+  ~MappedGraph();
+
+  // Operations
+  MappedGraph& operator=(MappedGraph&& other) noexcept;
+  MappedGraph& operator=(const MappedGraph&) = delete;
+
+  // Methods
+  // Reads the whole file to check that edge offsets never decrease, every target is a node and
+  // every string is within its table. Queries on a file that fails may read out of bounds.
+  bool Verify() const;
+  std::size_t NodeCount() const { return header_->node_count; }
+  std::size_t EdgeCount() const { return header_->edge_count; }
+  node_view Node(node_id id) const { return nodes_[id]; }
+  node_id Id(const N& val) const;
+  bool IsNode(const N& val) const { return Id(val) != npos; }
+  std::size_t OutDegree(node_id id) const { return offsets_[id + 1] - offsets_[id]; }
+  typename CsrGraph<N, E>::template span<node_id> Targets(node_id id) const;
+  // Weight of the i-th edge out of node id
+  weight_view Weight(node_id id, std::size_t i) const { return weights_[offsets_[id] + i]; }
+  bool IsConnected(const N& src, const N& dst) const;
+  std::vector<E> GetWeights(const N& src, const N& dst) const;
+  CsrGraph<N, E> ToCsrGraph() const;
+  Graph<N, E> ToGraph() const;
+
+ private:
+  void* data_;
+  std::size_t size_;
+  const FileHeader* header_;
+  detail::BinaryTable<N> nodes_;
+  const std::uint64_t* offsets_;
+  const node_id* targets_;
+  detail::BinaryTable<E> weights_;
+};
+
+// Append-only log of the batches passed to Graph::Apply, so a graph can be rebuilt from a saved
+// snapshot plus the batches applied since it was taken. Each batch is one record that starts
+// with its length and a checksum, so a record cut short by a crash is detected. Nodes and
+// weights are encoded like the values in the binary file format.
+//   LogHeader
+//   records        uint64_t payload bytes, uint64_t FNV-1a checksum of the payload, payload
+//   payload        uint64_t change count, then per change a uint8_t op, src, dst and weight
+struct LogHeader {
+  // "GDWL" on a little endian machine
+  static constexpr std::uint32_t kMagic = 0x4c574447;
+  static constexpr std::uint32_t kVersion = 1;
+
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint32_t node_encoding;
+  std::uint32_t node_size;
+  std::uint32_t weight_encoding;
+  std::uint32_t weight_size;
+};
+
+template <typename N, typename E>
+class DeltaLog {
+ public:
+  using batch = std::vector<typename Graph<N, E>::Mutation>;
+
+  // Constructors
+  // Opens path for appending, writing a header if the file is new. The log is cut at the first
+  // record that is partly written, fails its checksum or doesn't decode, so every record kept
+  // is one Replay applies.
+  // Throws std::runtime_error if the file can't be opened or is a log of other types
+  explicit DeltaLog(const std::string& path);
+
+  // Methods
+  // Writes the batch as one record and flushes it.
+  // Throws std::runtime_error if it can't be written
+  void Append(const batch& changes);
+
+ private:
+  std::ofstream out_;
+  std::string record_;
+};
+
+// Applies every complete record of the log at path to g in order and returns how many there were.
+// Throws std::runtime_error if the file can't be opened or is a log of other types
+template <typename N, typename E>
+std::size_t Replay(const std::string& path, Graph<N, E>& g);
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_GRAPH_IO_H_
+
+#include "assignments/dg/graph_io.tpp"
@@ -0,0 +1,541 @@
+#ifndef ASSIGNMENTS_DG_GRAPH_IO_TPP_
+#define ASSIGNMENTS_DG_GRAPH_IO_TPP_
+
+#include "assignments/dg/graph_io.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace gdwg {
+namespace detail {
+
+inline std::uint64_t AlignSection(std::uint64_t offset) {
+  return (offset + 15) / 16 * 16;
+}
+
+template <typename T>
+void WriteArray(std::ostream& os, const T* data, std::size_t count) {
+  os.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+// Pads the stream from offset to the start of the next section
+inline std::uint64_t WritePadding(std::ostream& os, std::uint64_t offset) {
+  static constexpr char zeros[16] = {};
+  auto aligned = AlignSection(offset);
+  os.write(zeros, static_cast<std::streamsize>(aligned - offset));
+  return aligned;
+}
+
+template <typename T>
+void BinaryTable<T, std::enable_if_t<std::is_trivially_copyable_v<T>>>::Write(
+    std::ostream& os,
+    const std::vector<T>& values) {
+  WriteArray(os, values.data(), values.size());
+}
+
+template <typename T>
+bool BinaryTable<T, std::enable_if_t<std::is_trivially_copyable_v<T>>>::Bind(const char* begin,
+                                                                            const char* end,
+                                                                            std::uint64_t count) {
+  static_assert(alignof(T) <= 16, "Sections are only aligned to 16 bytes");
+  if (static_cast<std::uint64_t>(end - begin) / sizeof(T) < count) {
+    return false;
+  }
+  data = reinterpret_cast<const T*>(begin);
+  return true;
+}
+
+template <typename T>
+void BinaryTable<T, std::enable_if_t<std::is_trivially_copyable_v<T>>>::Append(std::string& out,
+                                                                              const T& value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool BinaryTable<T, std::enable_if_t<std::is_trivially_copyable_v<T>>>::Read(const char*& p,
+                                                                            const char* end,
+                                                                            T& value) {
+  if (static_cast<std::size_t>(end - p) < sizeof(T)) {
+    return false;
+  }
+  std::memcpy(&value, p, sizeof(T));
+  p += sizeof(T);
+  return true;
+}
+
+inline std::uint64_t BinaryTable<std::string>::Bytes(const std::vector<std::string>& values) {
+  std::uint64_t bytes = (values.size() + 1) * sizeof(std::uint64_t);
+  for (const auto& value : values) {
+    bytes += value.size();
+  }
+  return bytes;
+}
+
+inline void BinaryTable<std::string>::Write(std::ostream& os,
+                                            const std::vector<std::string>& values) {
+  std::vector<std::uint64_t> offsets;
+  offsets.reserve(values.size() + 1);
+  offsets.push_back(0);
+  for (const auto& value : values) {
+    offsets.push_back(offsets.back() + value.size());
+  }
+  WriteArray(os, offsets.data(), offsets.size());
+  for (const auto& value : values) {
+    os.write(value.data(), static_cast<std::streamsize>(value.size()));
+  }
+}
+
+inline bool BinaryTable<std::string>::Bind(const char* begin,
+                                           const char* end,
+                                           std::uint64_t count) {
+  auto bytes = static_cast<std::uint64_t>(end - begin);
+  if (bytes / sizeof(std::uint64_t) <= count) {
+    return false;
+  }
+  offsets = reinterpret_cast<const std::uint64_t*>(begin);
+  chars = begin + (count + 1) * sizeof(std::uint64_t);
+  return offsets[0] == 0 && offsets[count] <= static_cast<std::uint64_t>(end - chars);
+}
+
+inline bool BinaryTable<std::string>::Verify(std::uint64_t count) const {
+  for (std::uint64_t i = 0; i < count; ++i) {
+    if (offsets[i + 1] < offsets[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+inline void BinaryTable<std::string>::Append(std::string& out, const std::string& value) {
+  BinaryTable<std::uint64_t>::Append(out, value.size());
+  out += value;
+}
+
+inline bool BinaryTable<std::string>::Read(const char*& p, const char* end, std::string& value) {
+  std::uint64_t size;
+  if (!BinaryTable<std::uint64_t>::Read(p, end, size) ||
+      size > static_cast<std::uint64_t>(end - p)) {
+    return false;
+  }
+  value.assign(p, size);
+  p += size;
+  return true;
+}
+
+inline std::uint64_t Fnv1a(const char* data, std::size_t size) {
+  std::uint64_t hash = 0xcbf29ce484222325;
+  for (std::size_t i = 0; i < size; ++i) {
+    hash = (hash ^ static_cast<unsigned char>(data[i])) * 0x100000001b3;
+  }
+  return hash;
+}
+
+template <typename N, typename E>
+LogHeader MakeLogHeader() {
+  LogHeader header{};
+  header.magic = LogHeader::kMagic;
+  header.version = LogHeader::kVersion;
+  header.node_encoding = BinaryTable<N>::encoding;
+  header.node_size = sizeof(N);
+  header.weight_encoding = BinaryTable<E>::encoding;
+  header.weight_size = sizeof(E);
+  return header;
+}
+
+// Reads a log's header, returning false if the stream is too short to hold one.
+// Throws std::runtime_error if it is the header of another kind of file.
+template <typename N, typename E>
+bool ReadLogHeader(std::istream& in, const std::string& path) {
+  LogHeader header;
+  if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    return false;
+  }
+  auto expected = MakeLogHeader<N, E>();
+  if (std::memcmp(&header, &expected, sizeof(header)) != 0) {
+    throw std::runtime_error("Cannot call gdwg::DeltaLog on " + path +
+                             " if it isn't a version 1 delta log of these types");
+  }
+  return true;
+}
+
+// Reads the payload of the next record, given the bytes left in the stream. Returns false at
+// the end of the log, or at a record that was cut short or fails its checksum.
+inline bool ReadRecord(std::istream& in, std::uint64_t remaining, std::string& payload) {
+  std::uint64_t header[2];
+  if (remaining < sizeof(header) || !in.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+      header[0] > remaining - sizeof(header)) {
+    return false;
+  }
+  payload.resize(header[0]);
+  return in.read(payload.data(), static_cast<std::streamsize>(payload.size())) &&
+         Fnv1a(payload.data(), payload.size()) == header[1];
+}
+
+template <typename N, typename E>
+bool DecodeBatch(const std::string& payload, std::vector<typename Graph<N, E>::Mutation>& changes) {
+  using op = typename Graph<N, E>::Mutation::Op;
+  const char* p = payload.data();
+  const char* end = p + payload.size();
+  std::uint64_t count;
+  if (!BinaryTable<std::uint64_t>::Read(p, end, count)) {
+    return false;
+  }
+  changes.clear();
+  for (std::uint64_t i = 0; i < count; ++i) {
+    std::uint8_t kind;
+    N src{};
+    N dst{};
+    E weight{};
+    if (!BinaryTable<std::uint8_t>::Read(p, end, kind) || kind > 1 ||
+        !BinaryTable<N>::Read(p, end, src) || !BinaryTable<N>::Read(p, end, dst) ||
+        !BinaryTable<E>::Read(p, end, weight)) {
+      return false;
+    }
+    changes.push_back({static_cast<op>(kind), std::move(src), std::move(dst), std::move(weight)});
+  }
+  return p == end;
+}
+
+// Reads and decodes the next record. DeltaLog keeps and Replay applies exactly the records up to
+// the first for which this returns false, so no acknowledged batch is kept but skipped.
+template <typename N, typename E>
+bool ReadBatch(std::istream& in,
+               std::uint64_t remaining,
+               std::string& payload,
+               std::vector<typename Graph<N, E>::Mutation>& changes) {
+  return ReadRecord(in, remaining, payload) && DecodeBatch<N, E>(payload, changes);
+}
+
+inline std::uint64_t StreamSize(std::istream& in) {
+  in.seekg(0, std::ios::end);
+  auto size = static_cast<std::uint64_t>(in.tellg());
+  in.seekg(0, std::ios::beg);
+  return size;
+}
+
+}  // namespace detail
+}  // namespace gdwg
+
+template <typename N, typename E>
+void gdwg::Save(const CsrGraph<N, E>& g, std::ostream& os) {
+  using node_table = detail::BinaryTable<N>;
+  using weight_table = detail::BinaryTable<E>;
+
+  FileHeader header{};
+  header.magic = FileHeader::kMagic;
+  header.version = FileHeader::kVersion;
+  header.node_encoding = node_table::encoding;
+  header.node_size = sizeof(N);
+  header.weight_encoding = weight_table::encoding;
+  header.weight_size = sizeof(E);
+  header.node_count = g.NodeCount();
+  header.edge_count = g.EdgeCount();
+  header.nodes_offset = detail::AlignSection(sizeof(FileHeader));
+  header.offsets_offset = detail::AlignSection(header.nodes_offset + node_table::Bytes(g.Nodes()));
+  header.targets_offset = detail::AlignSection(
+      header.offsets_offset + (header.node_count + 1) * sizeof(std::uint64_t));
+  header.weights_offset = detail::AlignSection(
+      header.targets_offset + header.edge_count * sizeof(typename CsrGraph<N, E>::node_id));
+  header.file_size = header.weights_offset + weight_table::Bytes(g.Weights());
+
+  detail::WriteArray(os, &header, 1);
+  detail::WritePadding(os, sizeof(FileHeader));
+  node_table::Write(os, g.Nodes());
+  detail::WritePadding(os, header.nodes_offset + node_table::Bytes(g.Nodes()));
+  if constexpr (std::is_same_v<std::size_t, std::uint64_t>) {
+    detail::WriteArray(os, g.Offsets().data(), g.Offsets().size());
+  } else {
+    std::vector<std::uint64_t> offsets(g.Offsets().begin(), g.Offsets().end());
+    detail::WriteArray(os, offsets.data(), offsets.size());
+  }
+  detail::WritePadding(os, header.offsets_offset + (header.node_count + 1) * sizeof(std::uint64_t));
+  detail::WriteArray(os, g.Targets().data(), g.Targets().size());
+  detail::WritePadding(
+      os, header.targets_offset + header.edge_count * sizeof(typename CsrGraph<N, E>::node_id));
+  weight_table::Write(os, g.Weights());
+  if (!os) {
+    throw std::runtime_error("Cannot call gdwg::Save if the stream can't be written to");
+  }
+}
+
+template <typename N, typename E>
+void gdwg::Save(const Graph<N, E>& g, std::ostream& os) {
+  Save(g.Freeze(), os);
+}
+
+// Begin constructors
+template <typename N, typename E>
+gdwg::MappedGraph<N, E>::MappedGraph(const std::string& path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Cannot call MappedGraph on " + path + " if it can't be opened");
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(FileHeader)) {
+    ::close(fd);
+    throw std::runtime_error("Cannot call MappedGraph on " + path + " if it isn't a graph file");
+  }
+  size_ = static_cast<std::size_t>(st.st_size);
+  data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data_ == MAP_FAILED) {
+    throw std::runtime_error("Cannot call MappedGraph on " + path + " if it can't be mapped");
+  }
+
+  // Check everything that can be checked without reading past the header
+  const char* base = static_cast<const char*>(data_);
+  header_ = reinterpret_cast<const FileHeader*>(base);
+  const auto& h = *header_;
+  bool ok = h.magic == FileHeader::kMagic && h.version == FileHeader::kVersion &&
+            h.file_size == size_ && h.node_count < npos && h.edge_count <= size_;
+  ok = ok && h.node_encoding == detail::BinaryTable<N>::encoding && h.node_size == sizeof(N) &&
+       h.weight_encoding == detail::BinaryTable<E>::encoding && h.weight_size == sizeof(E);
+  ok = ok && h.nodes_offset % 16 == 0 && h.offsets_offset % 16 == 0 &&
+       h.targets_offset % 16 == 0 && h.weights_offset % 16 == 0;
+  ok = ok && sizeof(FileHeader) <= h.nodes_offset && h.nodes_offset <= h.offsets_offset &&
+       h.offsets_offset <= h.targets_offset && h.targets_offset <= h.weights_offset &&
+       h.weights_offset <= size_;
+  ok = ok && (h.node_count + 1) * sizeof(std::uint64_t) <= h.targets_offset - h.offsets_offset &&
+       h.edge_count * sizeof(node_id) <= h.weights_offset - h.targets_offset;
+  ok = ok && nodes_.Bind(base + h.nodes_offset, base + h.offsets_offset, h.node_count) &&
+       weights_.Bind(base + h.weights_offset, base + size_, h.edge_count);
+  if (ok) {
+    offsets_ = reinterpret_cast<const std::uint64_t*>(base + h.offsets_offset);
+    targets_ = reinterpret_cast<const node_id*>(base + h.targets_offset);
+    ok = offsets_[0] == 0 && offsets_[h.node_count] == h.edge_count;
+  }
+  if (!ok) {
+    ::munmap(data_, size_);
+    throw std::runtime_error("Cannot call MappedGraph on " + path +
+                             " if it isn't a version 1 graph file of these types");
+  }
+}
+
+template <typename N, typename E>
+gdwg::MappedGraph<N, E>::MappedGraph(MappedGraph&& other) noexcept
+  : data_{std::exchange(other.data_, nullptr)}, size_{std::exchange(other.size_, 0)},
+    header_{other.header_}, nodes_{other.nodes_}, offsets_{other.offsets_},
+    targets_{other.targets_}, weights_{other.weights_} {}
+// end constructors
+
+template <typename N, typename E>
+gdwg::MappedGraph<N, E>::~MappedGraph() {
+  if (data_ != nullptr) {
+    ::munmap(data_, size_);
+  }
+}
+
+template <typename N, typename E>
+gdwg::MappedGraph<N, E>& gdwg::MappedGraph<N, E>::operator=(MappedGraph&& other) noexcept {
+  if (this != &other) {
+    if (data_ != nullptr) {
+      ::munmap(data_, size_);
+    }
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    header_ = other.header_;
+    nodes_ = other.nodes_;
+    offsets_ = other.offsets_;
+    targets_ = other.targets_;
+    weights_ = other.weights_;
+  }
+  return *this;
+}
+
+template <typename N, typename E>
+bool gdwg::MappedGraph<N, E>::Verify() const {
+  for (std::size_t i = 0; i < NodeCount(); ++i) {
+    if (offsets_[i + 1] < offsets_[i]) {
+      return false;
+    }
+  }
+  auto nodes = NodeCount();
+  bool targets_ok = std::all_of(targets_, targets_ + EdgeCount(),
+                                [nodes](node_id target) { return target < nodes; });
+  return targets_ok && nodes_.Verify(NodeCount()) && weights_.Verify(EdgeCount());
+}
+
+template <typename N, typename E>
+typename gdwg::MappedGraph<N, E>::node_id gdwg::MappedGraph<N, E>::Id(const N& val) const {
+  // Nodes are sorted, so the id of a node is its position
+  node_view key = val;
+  std::size_t low = 0;
+  std::size_t high = NodeCount();
+  while (low < high) {
+    auto mid = low + (high - low) / 2;
+    if (nodes_[mid] < key) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  if (low == NodeCount() || key < nodes_[low]) {
+    return npos;
+  }
+  return static_cast<node_id>(low);
+}
+
+template <typename N, typename E>
+typename gdwg::CsrGraph<N, E>::template span<typename gdwg::MappedGraph<N, E>::node_id>
+gdwg::MappedGraph<N, E>::Targets(node_id id) const {
+  return {targets_ + offsets_[id], OutDegree(id)};
+}
+
+template <typename N, typename E>
+bool gdwg::MappedGraph<N, E>::IsConnected(const N& src, const N& dst) const {
+  auto from = Id(src);
+  auto to = Id(dst);
+  if (from == npos || to == npos) {
+    throw std::out_of_range(
+        "Cannot call MappedGraph::IsConnected if src or dst node don't exist in the graph");
+  }
+  auto targets = Targets(from);
+  return std::binary_search(targets.begin(), targets.end(), to);
+}
+
+template <typename N, typename E>
+std::vector<E> gdwg::MappedGraph<N, E>::GetWeights(const N& src, const N& dst) const {
+  auto from = Id(src);
+  auto to = Id(dst);
+  if (from == npos || to == npos) {
+    throw std::out_of_range(
+        "Cannot call MappedGraph::GetWeights if src or dst node don't exist in the graph");
+  }
+  // Edges are sorted by (dst, weight), so the weights come back in Graph order
+  auto targets = Targets(from);
+  auto range = std::equal_range(targets.begin(), targets.end(), to);
+  std::vector<E> vec;
+  for (auto it = range.first; it != range.second; ++it) {
+    vec.emplace_back(Weight(from, static_cast<std::size_t>(it - targets.begin())));
+  }
+  return vec;
+}
+
+template <typename N, typename E>
+gdwg::CsrGraph<N, E> gdwg::MappedGraph<N, E>::ToCsrGraph() const {
+  std::vector<N> nodes;
+  nodes.reserve(NodeCount());
+  for (std::size_t i = 0; i < NodeCount(); ++i) {
+    nodes.emplace_back(nodes_[i]);
+  }
+  std::vector<std::size_t> offsets(offsets_, offsets_ + NodeCount() + 1);
+  std::vector<node_id> targets(targets_, targets_ + EdgeCount());
+  std::vector<E> weights;
+  weights.reserve(EdgeCount());
+  for (std::size_t i = 0; i < EdgeCount(); ++i) {
+    weights.emplace_back(weights_[i]);
+  }
+  return CsrGraph<N, E>{std::move(nodes), std::move(offsets), std::move(targets),
+                        std::move(weights)};
+}
+
+template <typename N, typename E>
+gdwg::Graph<N, E> gdwg::MappedGraph<N, E>::ToGraph() const {
+  std::vector<std::tuple<N, N, E>> edges;
+  edges.reserve(EdgeCount());
+  for (node_id src = 0; src < NodeCount(); ++src) {
+    for (auto i = offsets_[src]; i < offsets_[src + 1]; ++i) {
+      edges.emplace_back(N(nodes_[src]), N(nodes_[targets_[i]]), E(weights_[i]));
+    }
+  }
+  auto g = Graph<N, E>::BulkLoad(std::make_move_iterator(edges.begin()),
+                                 std::make_move_iterator(edges.end()));
+  // Nodes without edges aren't in the edge list
+  for (std::size_t i = 0; i < NodeCount(); ++i) {
+    if (offsets_[i] == offsets_[i + 1]) {
+      g.InsertNode(N(nodes_[i]));
+    }
+  }
+  return g;
+}
+
+// Begin constructors
+template <typename N, typename E>
+gdwg::DeltaLog<N, E>::DeltaLog(const std::string& path) {
+  // Find where the last whole record ends
+  std::uint64_t size = 0;
+  std::uint64_t valid = 0;
+  {
+    std::ifstream in{path, std::ios::binary};
+    if (in) {
+      size = detail::StreamSize(in);
+      if (detail::ReadLogHeader<N, E>(in, path)) {
+        valid = sizeof(LogHeader);
+        std::string payload;
+        std::vector<typename Graph<N, E>::Mutation> changes;
+        while (detail::ReadBatch<N, E>(in, size - valid, payload, changes)) {
+          valid += 2 * sizeof(std::uint64_t) + payload.size();
+        }
+      }
+    }
+  }
+  if (valid < size) {
+    std::filesystem::resize_file(path, valid);
+  }
+  out_.open(path, std::ios::binary | std::ios::app);
+  if (!out_) {
+    throw std::runtime_error("Cannot call gdwg::DeltaLog on " + path + " if it can't be opened");
+  }
+  if (valid == 0) {
+    auto header = detail::MakeLogHeader<N, E>();
+    detail::WriteArray(out_, &header, 1);
+    out_.flush();
+  }
+}
+// end constructors
+
+template <typename N, typename E>
+void gdwg::DeltaLog<N, E>::Append(const batch& changes) {
+  // Leave room for the record's header, which needs the payload's size and checksum
+  record_.assign(2 * sizeof(std::uint64_t), '\0');
+  detail::BinaryTable<std::uint64_t>::Append(record_, changes.size());
+  for (const auto& change : changes) {
+    detail::BinaryTable<std::uint8_t>::Append(record_, static_cast<std::uint8_t>(change.op));
+    detail::BinaryTable<N>::Append(record_, change.src);
+    detail::BinaryTable<N>::Append(record_, change.dst);
+    detail::BinaryTable<E>::Append(record_, change.weight);
+  }
+  std::uint64_t header[2];
+  header[0] = record_.size() - sizeof(header);
+  header[1] = detail::Fnv1a(record_.data() + sizeof(header), header[0]);
+  std::memcpy(record_.data(), header, sizeof(header));
+  out_.write(record_.data(), static_cast<std::streamsize>(record_.size()));
+  out_.flush();
+  if (!out_) {
+    throw std::runtime_error("Cannot call gdwg::DeltaLog::Append if the log can't be written to");
+  }
+}
+
+template <typename N, typename E>
+std::size_t gdwg::Replay(const std::string& path, Graph<N, E>& g) {
+  std::ifstream in{path, std::ios::binary};
+  if (!in) {
+    throw std::runtime_error("Cannot call gdwg::Replay on " + path + " if it can't be opened");
+  }
+  auto size = detail::StreamSize(in);
+  if (!detail::ReadLogHeader<N, E>(in, path)) {
+    return 0;
+  }
+  std::uint64_t position = sizeof(LogHeader);
+  std::size_t replayed = 0;
+  std::string payload;
+  std::vector<typename Graph<N, E>::Mutation> changes;
+  while (detail::ReadBatch<N, E>(in, size - position, payload, changes)) {
+    position += 2 * sizeof(std::uint64_t) + payload.size();
+    g.Apply(changes);
+    ++replayed;
+  }
+  return replayed;
+}
+
+#endif
@@ -4,11 +4,35 @@ The objective of testing is to run over every single line of code that has been
 
 */
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <random>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <utility>
 
+#include "assignments/dg/bfs.h"
+#include "assignments/dg/components.h"
+#include "assignments/dg/concurrent_graph.h"
+#include "assignments/dg/edge_list.h"
+#include "assignments/dg/flat_graph.h"
+#include "assignments/dg/generators.h"
 #include "assignments/dg/graph.h"
+#include "assignments/dg/graph_export.h"
+#include "assignments/dg/graph_io.h"
+#include "assignments/dg/interned_graph.h"
+#include "assignments/dg/pagerank.h"
+#include "assignments/dg/parallel.h"
+#include "assignments/dg/shortest_paths.h"
+#include "assignments/dg/topological_sort.h"
+#include "assignments/dg/watched_graph.h"
 #include "catch.h"
 
 SCENARIO("Default constructor test") {
@@ -518,3 +542,1668 @@ SCENARIO("Reverse Iterator") {
     }
   }
 }
+
+SCENARIO("Reverse Iterator within the first node") {
+  WHEN("The first node has more than one edge") {
+    std::string s1{"A"};
+    std::string s2{"B"};
+    std::string s3{"C"};
+    auto e1 = std::make_tuple(s1, s2, 1);
+    auto e2 = std::make_tuple(s1, s3, 2);
+    auto e3 = std::make_tuple(s2, s3, 3);
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{e1, e2, e3};
+    gdwg::Graph<std::string, int> new_graph{e.begin(), e.end()};
+    THEN("Decrementing from its second edge reaches its first") {
+      auto it = new_graph.find(s1, s3, 2);
+      it--;
+      REQUIRE(it == new_graph.begin());
+      REQUIRE(e1 == std::make_tuple(std::get<0>(*it), std::get<1>(*it), std::get<2>(*it)));
+      auto reversed = std::vector<std::tuple<std::string, std::string, int>>{};
+      for (auto kt = new_graph.rbegin(); kt != new_graph.rend(); ++kt) {
+        reversed.emplace_back(std::get<0>(*kt), std::get<1>(*kt), std::get<2>(*kt));
+      }
+      REQUIRE(reversed == std::vector<std::tuple<std::string, std::string, int>>{e3, e2, e1});
+    }
+  }
+}
+
+SCENARIO("Replace keeps nodes and edges ordered") {
+  WHEN("graph.Replace() renames a node that other nodes have edges to") {
+    std::string s1{"B"};
+    std::string s2{"C"};
+    std::string s3{"D"};
+    auto e1 = std::make_tuple(s1, s2, 1);
+    auto e2 = std::make_tuple(s1, s3, 2);
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{e1, e2};
+    gdwg::Graph<std::string, int> new_graph{e.begin(), e.end()};
+    new_graph.Replace("D", "A");
+    std::vector<std::string> nodes{"A", "B", "C"};
+    std::vector<std::string> connected{"A", "C"};
+    THEN("The renamed node can be found and is sorted in both the nodes and the edges") {
+      REQUIRE(new_graph.GetNodes() == nodes);
+      REQUIRE(new_graph.IsNode("A"));
+      REQUIRE(!new_graph.IsNode("D"));
+      REQUIRE(new_graph.GetConnected("B") == connected);
+      REQUIRE(new_graph.GetWeights("B", "A") == std::vector<int>{2});
+      REQUIRE(new_graph.find("B", "A", 2) != new_graph.end());
+    }
+  }
+}
+
+SCENARIO("MergeReplace with duplicate edges") {
+  WHEN("graph.MergeReplace() merges nodes that share edges") {
+    std::string s1{"A"};
+    std::string s2{"B"};
+    std::string s3{"C"};
+    auto e1 = std::make_tuple(s1, s3, 1);
+    auto e2 = std::make_tuple(s2, s3, 1);
+    auto e3 = std::make_tuple(s3, s1, 2);
+    auto e4 = std::make_tuple(s3, s2, 2);
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{e1, e2, e3, e4};
+    gdwg::Graph<std::string, int> new_graph{e.begin(), e.end()};
+    new_graph.MergeReplace("A", "B");
+    std::vector<std::string> nodes{"B", "C"};
+    THEN("Duplicate incoming and outgoing edges are removed") {
+      REQUIRE(new_graph.GetNodes() == nodes);
+      REQUIRE(new_graph.GetWeights("B", "C") == std::vector<int>{1});
+      REQUIRE(new_graph.GetWeights("C", "B") == std::vector<int>{2});
+      REQUIRE(new_graph.GetConnected("C") == std::vector<std::string>{"B"});
+    }
+  }
+}
+
+SCENARIO("GetPredecessors method") {
+  WHEN("graph.GetPredecessors() is called after edges are added and removed") {
+    std::string s1{"A"};
+    std::string s2{"B"};
+    std::string s3{"C"};
+    std::string s4{"D"};
+    auto e1 = std::make_tuple(s1, s2, 3);
+    auto e2 = std::make_tuple(s3, s2, 2);
+    auto e3 = std::make_tuple(s4, s2, 4);
+    auto e4 = std::make_tuple(s4, s2, 5);
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{e1, e2, e3, e4};
+    gdwg::Graph<std::string, int> new_graph{e.begin(), e.end()};
+    THEN("Each node with an edge into dst is returned once, in order") {
+      REQUIRE(new_graph.GetPredecessors("B") == std::vector<std::string>{"A", "C", "D"});
+      REQUIRE(new_graph.GetPredecessors("A").empty());
+      REQUIRE(new_graph.erase("D", "B", 4));
+      REQUIRE(new_graph.GetPredecessors("B") == std::vector<std::string>{"A", "C", "D"});
+      REQUIRE(new_graph.erase("D", "B", 5));
+      REQUIRE(new_graph.GetPredecessors("B") == std::vector<std::string>{"A", "C"});
+      REQUIRE(new_graph.DeleteNode("A"));
+      REQUIRE(new_graph.GetPredecessors("B") == std::vector<std::string>{"C"});
+      new_graph.MergeReplace("C", "D");
+      REQUIRE(new_graph.GetPredecessors("B") == std::vector<std::string>{"D"});
+      REQUIRE(new_graph.Replace("D", "A"));
+      REQUIRE(new_graph.GetPredecessors("B") == std::vector<std::string>{"A"});
+      REQUIRE(new_graph.DeleteNode("B"));
+      REQUIRE(new_graph.GetConnected("A").empty());
+      new_graph.Clear();
+      REQUIRE(new_graph.GetNodes().empty());
+    }
+  }
+}
+
+SCENARIO("Predecessors follow the graph through copies") {
+  WHEN("A graph with a self loop is copied and then changed") {
+    std::string s1{"A"};
+    std::string s2{"B"};
+    auto e1 = std::make_tuple(s1, s1, 1);
+    auto e2 = std::make_tuple(s2, s1, 2);
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{e1, e2};
+    gdwg::Graph<std::string, int> new_graph{e.begin(), e.end()};
+    gdwg::Graph<std::string, int> copy_graph{new_graph};
+    copy_graph.MergeReplace("A", "B");
+    THEN("Only the copy changes, and its self loop is redirected") {
+      REQUIRE(new_graph.GetPredecessors("A") == std::vector<std::string>{"A", "B"});
+      REQUIRE(copy_graph.GetPredecessors("B") == std::vector<std::string>{"B"});
+      REQUIRE(copy_graph.GetWeights("B", "B") == std::vector<int>{1, 2});
+    }
+  }
+}
+
+SCENARIO("Freeze method") {
+  WHEN("graph.Freeze() is called") {
+    std::string s1{"A"};
+    std::string s2{"B"};
+    std::string s3{"C"};
+    std::string s4{"D"};
+    auto e1 = std::make_tuple(s4, s2, 4);
+    auto e2 = std::make_tuple(s1, s3, 2);
+    auto e3 = std::make_tuple(s1, s2, 3);
+    auto e4 = std::make_tuple(s1, s2, 1);
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{e1, e2, e3, e4};
+    gdwg::Graph<std::string, int> new_graph{e.begin(), e.end()};
+    auto frozen = new_graph.Freeze();
+    THEN("The snapshot has dense ids and visits edges in the graph's order") {
+      REQUIRE(frozen.NodeCount() == 4);
+      REQUIRE(frozen.EdgeCount() == 4);
+      REQUIRE(frozen.Id("A") == 0);
+      REQUIRE(frozen.Node(frozen.Id("D")) == "D");
+      REQUIRE(!frozen.IsNode("E"));
+      REQUIRE(frozen.OutDegree(frozen.Id("C")) == 0);
+
+      auto targets = frozen.Targets(frozen.Id("A"));
+      auto weights = frozen.Weights(frozen.Id("A"));
+      REQUIRE(targets.size() == 3);
+      REQUIRE(frozen.Node(targets[0]) == "B");
+      REQUIRE(weights[0] == 1);
+      REQUIRE(frozen.Node(targets[2]) == "C");
+      REQUIRE(weights[2] == 2);
+
+      auto it = new_graph.begin();
+      for (const auto& [from, to, weight] : frozen) {
+        REQUIRE(std::make_tuple(from, to, weight) ==
+                std::make_tuple(std::get<0>(*it), std::get<1>(*it), std::get<2>(*it)));
+        ++it;
+      }
+      REQUIRE(it == new_graph.end());
+
+      auto last = frozen.end();
+      --last;
+      REQUIRE(std::get<0>(*last) == "D");
+      REQUIRE(last.Source() == frozen.Id("D"));
+    }
+  }
+}
+
+SCENARIO("Graph is reused after Clear") {
+  WHEN("graph.Clear() returns the graph's memory and the graph is filled again") {
+    std::string s1{"A"};
+    std::string s2{"B"};
+    auto e1 = std::make_tuple(s1, s2, 1);
+    auto e2 = std::make_tuple(s2, s1, 2);
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{e1, e2};
+    gdwg::Graph<std::string, int> new_graph{e.begin(), e.end()};
+    new_graph.Clear();
+    new_graph.InsertNode("C");
+    new_graph.InsertNode("D");
+    new_graph.InsertEdge("C", "D", 3);
+    gdwg::Graph<std::string, int> copy_graph{new_graph};
+    THEN("The new nodes and edges are stored and copied like any others") {
+      REQUIRE(new_graph.GetNodes() == std::vector<std::string>{"C", "D"});
+      REQUIRE(new_graph.GetPredecessors("D") == std::vector<std::string>{"C"});
+      REQUIRE(copy_graph == new_graph);
+      new_graph.Clear();
+      REQUIRE(new_graph.begin() == new_graph.end());
+
+      gdwg::Graph<int, int> int_graph{1, 2};
+      int_graph.InsertEdge(1, 2, 3);
+      int_graph.Clear();
+      REQUIRE(int_graph.InsertNode(4));
+      REQUIRE(int_graph.InsertNode(5));
+      REQUIRE(int_graph.InsertEdge(4, 5, 6));
+      REQUIRE(int_graph.GetNodes() == std::vector<int>{4, 5});
+      REQUIRE(int_graph.GetPredecessors(5) == std::vector<int>{4});
+    }
+  }
+}
+
+SCENARIO("Moving a graph keeps its edges and leaves the source usable") {
+  WHEN("A graph is move constructed and move assigned") {
+    std::string s1{"A"};
+    std::string s2{"B"};
+    std::string s3{"C"};
+    auto e1 = std::make_tuple(s1, s2, 1);
+    auto e2 = std::make_tuple(s2, s3, 2);
+    auto e3 = std::make_tuple(s3, s1, 3);
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{e1, e2, e3};
+    gdwg::Graph<std::string, int> new_graph{e.begin(), e.end()};
+    gdwg::Graph<std::string, int> expected{new_graph};
+    gdwg::Graph<std::string, int> moved_graph{std::move(new_graph)};
+    gdwg::Graph<std::string, int> assigned_graph{"X"};
+    assigned_graph = std::move(moved_graph);
+    THEN("The destination has every edge and the sources can be filled again") {
+      REQUIRE(assigned_graph == expected);
+      REQUIRE(assigned_graph.GetPredecessors("A") == std::vector<std::string>{"C"});
+      REQUIRE(moved_graph.GetNodes().empty());
+      REQUIRE(new_graph.InsertNode("D"));
+      REQUIRE(new_graph.InsertNode("E"));
+      REQUIRE(new_graph.InsertEdge("D", "E", 4));
+      REQUIRE(new_graph.GetConnected("D") == std::vector<std::string>{"E"});
+      new_graph = assigned_graph;
+      REQUIRE(new_graph == expected);
+    }
+  }
+}
+
+SCENARIO("Copying a graph") {
+  WHEN("A graph is copied, then the copy is changed and assigned to itself") {
+    std::string s1{"A"};
+    std::string s2{"B"};
+    auto e1 = std::make_tuple(s1, s2, 1);
+    auto e2 = std::make_tuple(s1, s2, 2);
+    auto e3 = std::make_tuple(s2, s2, 3);
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{e1, e2, e3};
+    gdwg::Graph<std::string, int> new_graph{e.begin(), e.end()};
+    gdwg::Graph<std::string, int> copy_graph{new_graph};
+    THEN("The copy has the same edges and is independent of the original") {
+      REQUIRE(copy_graph == new_graph);
+      REQUIRE(copy_graph.GetWeights("A", "B") == std::vector<int>{1, 2});
+      REQUIRE(copy_graph.GetPredecessors("B") == std::vector<std::string>{"A", "B"});
+      REQUIRE(copy_graph.erase("A", "B", 1));
+      REQUIRE(new_graph.GetWeights("A", "B") == std::vector<int>{1, 2});
+      auto& self = copy_graph;
+      copy_graph = self;
+      REQUIRE(copy_graph.GetWeights("A", "B") == std::vector<int>{2});
+    }
+  }
+}
+
+SCENARIO("BulkLoad builder") {
+  WHEN("Graph::BulkLoad() is given unsorted edges with duplicates and self loops") {
+    std::string s1{"A"};
+    std::string s2{"B"};
+    std::string s3{"C"};
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{
+        std::make_tuple(s3, s1, 2), std::make_tuple(s1, s2, 5), std::make_tuple(s1, s2, 1),
+        std::make_tuple(s3, s1, 2), std::make_tuple(s2, s2, 4), std::make_tuple(s1, s3, 1)};
+    gdwg::Graph<std::string, int> expected;
+    for (const auto& [from, to, weight] : e) {
+      expected.InsertNode(from);
+      expected.InsertNode(to);
+      expected.InsertEdge(from, to, weight);
+    }
+    auto copied = gdwg::Graph<std::string, int>::BulkLoad(e.begin(), e.end());
+    auto moved = gdwg::Graph<std::string, int>::BulkLoad(std::make_move_iterator(e.begin()),
+                                                         std::make_move_iterator(e.end()));
+    THEN("It builds the same graph as inserting the edges one at a time") {
+      REQUIRE(copied == expected);
+      REQUIRE(moved == expected);
+      REQUIRE(moved.GetNodes() == std::vector<std::string>{"A", "B", "C"});
+      REQUIRE(moved.GetWeights("A", "B") == std::vector<int>{1, 5});
+      REQUIRE(moved.GetPredecessors("B") == std::vector<std::string>{"A", "B"});
+      REQUIRE(moved.GetPredecessors("A") == std::vector<std::string>{"C"});
+      REQUIRE(gdwg::Graph<std::string, int>::BulkLoad(e.end(), e.end()).GetNodes().empty());
+    }
+  }
+}
+
+SCENARIO("Dijkstra shortest paths") {
+  WHEN("gdwg::Dijkstra() is called on graphs with integral and floating point weights") {
+    std::string s1{"A"};
+    std::string s2{"B"};
+    std::string s3{"C"};
+    std::string s4{"D"};
+    std::string s5{"E"};
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{
+        std::make_tuple(s1, s2, 7), std::make_tuple(s1, s3, 2), std::make_tuple(s3, s2, 3),
+        std::make_tuple(s2, s4, 1), std::make_tuple(s3, s4, 8), std::make_tuple(s4, s1, 1)};
+    gdwg::Graph<std::string, int> new_graph{e.begin(), e.end()};
+    new_graph.InsertNode(s5);
+    auto d = std::vector<std::tuple<std::string, std::string, double>>{
+        std::make_tuple(s1, s2, 0.5), std::make_tuple(s2, s3, 0.25), std::make_tuple(s1, s3, 1.0)};
+    gdwg::Graph<std::string, double> double_graph{d.begin(), d.end()};
+    THEN("Distances and predecessors describe the shortest paths") {
+      auto paths = gdwg::Dijkstra(new_graph, s1);
+      REQUIRE(paths.distance == std::map<std::string, int>{{"A", 0}, {"B", 5}, {"C", 2}, {"D", 6}});
+      REQUIRE(paths.predecessor ==
+              std::map<std::string, std::string>{{"B", "C"}, {"C", "A"}, {"D", "B"}});
+      REQUIRE(gdwg::PathTo(paths, s4) == std::vector<std::string>{"A", "C", "B", "D"});
+      REQUIRE(gdwg::PathTo(paths, s5).empty());
+
+      auto early = gdwg::Dijkstra(new_graph, s1, s2);
+      REQUIRE(early.distance.at("B") == 5);
+      REQUIRE(early.distance.count("D") == 0);
+
+      auto double_paths = gdwg::Dijkstra(double_graph, s1);
+      REQUIRE(double_paths.distance.at("C") == 0.75);
+      REQUIRE(double_paths.predecessor.at("C") == "B");
+
+      REQUIRE_THROWS_AS(gdwg::Dijkstra(new_graph, std::string{"Z"}), std::out_of_range);
+      new_graph.InsertEdge(s2, s5, -1);
+      REQUIRE_THROWS_AS(gdwg::Dijkstra(new_graph, s1), std::domain_error);
+    }
+  }
+}
+
+SCENARIO("Bellman-Ford shortest paths") {
+  WHEN("gdwg::BellmanFord() is called on a graph with negative weights") {
+    std::string s1{"A"};
+    std::string s2{"B"};
+    std::string s3{"C"};
+    std::string s4{"D"};
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{
+        std::make_tuple(s1, s2, 4), std::make_tuple(s1, s3, 2), std::make_tuple(s2, s3, -3),
+        std::make_tuple(s3, s4, 1)};
+    gdwg::Graph<std::string, int> new_graph{e.begin(), e.end()};
+    THEN("Negative weights are used and negative cycles are reported") {
+      auto paths = gdwg::BellmanFord(new_graph, s1);
+      REQUIRE(paths.distance == std::map<std::string, int>{{"A", 0}, {"B", 4}, {"C", 1}, {"D", 2}});
+      REQUIRE(gdwg::PathTo(paths, s4) == std::vector<std::string>{"A", "B", "C", "D"});
+      REQUIRE(gdwg::BellmanFord(new_graph, s4).distance.size() == 1);
+      new_graph.InsertEdge(s3, s2, 1);
+      REQUIRE_THROWS_AS(gdwg::BellmanFord(new_graph, s1), std::domain_error);
+      REQUIRE(gdwg::BellmanFord(new_graph, s4).distance.size() == 1);
+    }
+  }
+}
+
+SCENARIO("Breadth first search") {
+  WHEN("gdwg::BreadthFirstSearch() is called on a frozen graph") {
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{
+        std::make_tuple("A", "B", 1), std::make_tuple("A", "C", 1), std::make_tuple("B", "D", 1),
+        std::make_tuple("C", "D", 1), std::make_tuple("D", "E", 1), std::make_tuple("F", "A", 1)};
+    gdwg::Graph<std::string, int> new_graph{e.begin(), e.end()};
+    auto frozen = new_graph.Freeze();
+    auto unreached = gdwg::BfsResult::unreached;
+    THEN("The reverse index lists the sources of each node's in-edges") {
+      REQUIRE(frozen.InDegree(frozen.Id("D")) == 2);
+      auto sources = frozen.Sources(frozen.Id("D"));
+      REQUIRE(std::vector<std::uint32_t>(sources.begin(), sources.end()) ==
+              std::vector<std::uint32_t>{frozen.Id("B"), frozen.Id("C")});
+      REQUIRE(frozen.InDegree(frozen.Id("F")) == 0);
+    }
+    THEN("Depths and parents agree whichever direction and thread count is used") {
+      // alpha decides how soon the search goes bottom-up, beta how soon it comes back
+      for (double alpha : {0.0, 1e9}) {
+        for (std::size_t threads : {1, 3}) {
+          auto result = gdwg::BreadthFirstSearch(frozen, frozen.Id("A"), {threads, alpha, 1e9});
+          REQUIRE(result.depth == std::vector<std::uint32_t>{0, 1, 1, 2, 3, unreached});
+          REQUIRE(result.parent[frozen.Id("A")] == frozen.Id("A"));
+          REQUIRE(result.parent[frozen.Id("E")] == frozen.Id("D"));
+          REQUIRE(result.parent[frozen.Id("F")] == unreached);
+          REQUIRE(result.levels.size() == 4);
+          REQUIRE(result.levels[1].frontier == 2);
+          REQUIRE(result.levels[1].bottom_up == (alpha > 1));
+        }
+      }
+      REQUIRE_THROWS_AS(gdwg::BreadthFirstSearch(frozen, frozen.Id("Z")), std::out_of_range);
+    }
+  }
+}
+
+SCENARIO("Binary files") {
+  WHEN("A graph is saved and mapped back in") {
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{
+        std::make_tuple("A", "B", 3), std::make_tuple("A", "B", 1), std::make_tuple("B", "C", 2),
+        std::make_tuple("C", "A", 4)};
+    gdwg::Graph<std::string, int> new_graph{e.begin(), e.end()};
+    new_graph.InsertNode("D");
+    auto path = (std::filesystem::temp_directory_path() / "gdwg_binary_file_test").string();
+    {
+      std::ofstream out{path, std::ios::binary};
+      gdwg::Save(new_graph, out);
+    }
+    gdwg::MappedGraph<std::string, int> mapped{path};
+    THEN("Queries are answered from the mapping and the graph can be rebuilt") {
+      REQUIRE(mapped.NodeCount() == 4);
+      REQUIRE(mapped.EdgeCount() == 4);
+      REQUIRE(mapped.Node(mapped.Id("C")) == "C");
+      REQUIRE(mapped.IsNode("D"));
+      REQUIRE_FALSE(mapped.IsNode("E"));
+      REQUIRE(mapped.IsConnected("A", "B"));
+      REQUIRE_FALSE(mapped.IsConnected("B", "A"));
+      REQUIRE(mapped.GetWeights("A", "B") == std::vector<int>{1, 3});
+      REQUIRE_THROWS_AS(mapped.GetWeights("A", "E"), std::out_of_range);
+      REQUIRE(mapped.ToGraph() == new_graph);
+      auto frozen = mapped.ToCsrGraph();
+      REQUIRE(std::vector<std::tuple<std::string, std::string, int>>(frozen.begin(), frozen.end()) ==
+              std::vector<std::tuple<std::string, std::string, int>>(new_graph.begin(),
+                                                                     new_graph.end()));
+      gdwg::MappedGraph<std::string, int> moved{std::move(mapped)};
+      REQUIRE(moved.OutDegree(moved.Id("A")) == 2);
+    }
+    THEN("Files of other types are rejected") {
+      REQUIRE_THROWS_AS((gdwg::MappedGraph<int, int>{path}), std::runtime_error);
+      REQUIRE_THROWS_AS((gdwg::MappedGraph<std::string, int>{path + ".missing"}), std::runtime_error);
+    }
+    std::remove(path.c_str());
+  }
+  WHEN("A graph of trivially copyable types is saved and mapped back in") {
+    auto e = std::vector<std::tuple<int, int, double>>{std::make_tuple(1, 2, 0.5),
+                                                       std::make_tuple(2, 3, 1.5)};
+    gdwg::Graph<int, double> new_graph{e.begin(), e.end()};
+    auto path = (std::filesystem::temp_directory_path() / "gdwg_binary_file_test_int").string();
+    {
+      std::ofstream out{path, std::ios::binary};
+      gdwg::Save(new_graph, out);
+    }
+    gdwg::MappedGraph<int, double> mapped{path};
+    THEN("Nodes and weights are read in place") {
+      REQUIRE(&mapped.Node(0) + 1 == &mapped.Node(1));
+      REQUIRE(mapped.Weight(mapped.Id(2), 0) == 1.5);
+      REQUIRE(mapped.ToGraph() == new_graph);
+    }
+    std::remove(path.c_str());
+  }
+  WHEN("A saved file is corrupted inside its sections") {
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{
+        std::make_tuple("A", "B", 1), std::make_tuple("B", "C", 2)};
+    gdwg::Graph<std::string, int> new_graph{e.begin(), e.end()};
+    auto path = (std::filesystem::temp_directory_path() / "gdwg_binary_file_corrupt").string();
+    {
+      std::ofstream out{path, std::ios::binary};
+      gdwg::Save(new_graph, out);
+    }
+    gdwg::FileHeader header{};
+    {
+      std::ifstream in{path, std::ios::binary};
+      in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    }
+    // Overwrites the value at offset in the file
+    auto corrupt = [&path](std::uint64_t offset, auto value) {
+      std::fstream file{path, std::ios::binary | std::ios::in | std::ios::out};
+      file.seekp(static_cast<std::streamoff>(offset));
+      file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    THEN("Opening still succeeds and Verify() finds the damage") {
+      REQUIRE(gdwg::MappedGraph<std::string, int>{path}.Verify());
+      corrupt(header.targets_offset, std::uint32_t{7});
+      REQUIRE_FALSE(gdwg::MappedGraph<std::string, int>{path}.Verify());
+      corrupt(header.targets_offset, std::uint32_t{1});
+      corrupt(header.offsets_offset + 2 * sizeof(std::uint64_t), std::uint64_t{0});
+      REQUIRE_FALSE(gdwg::MappedGraph<std::string, int>{path}.Verify());
+      corrupt(header.offsets_offset + 2 * sizeof(std::uint64_t), std::uint64_t{2});
+      REQUIRE(gdwg::MappedGraph<std::string, int>{path}.Verify());
+      corrupt(header.nodes_offset + sizeof(std::uint64_t), std::uint64_t{9});
+      REQUIRE_FALSE(gdwg::MappedGraph<std::string, int>{path}.Verify());
+    }
+    std::remove(path.c_str());
+  }
+}
+
+SCENARIO("Thawing a frozen graph") {
+  WHEN("Graph::Thaw() is called on the result of Freeze()") {
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{
+        std::make_tuple("A", "B", 3), std::make_tuple("A", "B", 1), std::make_tuple("C", "B", 2),
+        std::make_tuple("B", "B", 4)};
+    gdwg::Graph<std::string, int> new_graph{e.begin(), e.end()};
+    new_graph.InsertNode("D");
+    auto thawed = gdwg::Graph<std::string, int>::Thaw(new_graph.Freeze());
+    THEN("The same graph is built, predecessors included") {
+      REQUIRE(thawed == new_graph);
+      REQUIRE(thawed.GetPredecessors("B") == std::vector<std::string>{"A", "B", "C"});
+      REQUIRE(thawed.DeleteNode("A"));
+      REQUIRE(thawed.GetPredecessors("B") == std::vector<std::string>{"B", "C"});
+    }
+  }
+}
+
+SCENARIO("Loading edge lists") {
+  WHEN("gdwg::LoadEdgeList() reads a text edge list in small chunks on several threads") {
+    std::istringstream text{"# src dst weight\n"
+                            "A B 3\n"
+                            "\n"
+                            "a_long_node_name\tB -2\r\n"
+                            "A B 1\n"
+                            "  C A 7  \n"
+                            "A B 3\n"
+                            "B a_long_node_name 5"};
+    gdwg::EdgeListStats stats;
+    auto loaded = gdwg::LoadEdgeList<int>(text, {3, 8}, &stats);
+    THEN("The graph matches one built from the same edges") {
+      auto e = std::vector<std::tuple<std::string, std::string, int>>{
+          std::make_tuple("A", "B", 3), std::make_tuple("a_long_node_name", "B", -2),
+          std::make_tuple("A", "B", 1), std::make_tuple("C", "A", 7),
+          std::make_tuple("B", "a_long_node_name", 5)};
+      gdwg::Graph<std::string, int> expected{e.begin(), e.end()};
+      REQUIRE(loaded == expected);
+      REQUIRE(loaded.GetPredecessors("B") == std::vector<std::string>{"A", "a_long_node_name"});
+      REQUIRE(stats.lines == 8);
+      REQUIRE(stats.nodes == 4);
+      REQUIRE(stats.edges == 5);
+      REQUIRE(stats.bytes == text.str().size());
+    }
+  }
+  WHEN("A line is malformed") {
+    std::istringstream text{"A B 1\nA B x\n"};
+    THEN("The line is reported") {
+      REQUIRE_THROWS_WITH(gdwg::LoadEdgeList<int>(text),
+                          "Cannot call gdwg::LoadEdgeList on input with a malformed line 2");
+    }
+  }
+}
+
+SCENARIO("Concurrent readers") {
+  WHEN("A reader holds a snapshot while batches are committed") {
+    gdwg::ConcurrentGraph<std::string, int> shared{gdwg::Graph<std::string, int>{"A", "B"}};
+    auto before = shared.Read();
+    auto version = shared.Commit([](gdwg::Graph<std::string, int>& g) {
+      g.InsertEdge("A", "B", 1);
+      g.InsertNode("C");
+    });
+    THEN("The old snapshot is unchanged and new readers see the whole batch") {
+      REQUIRE(before.Version() == 0);
+      REQUIRE(before->EdgeCount() == 0);
+      REQUIRE(before->NodeCount() == 2);
+      auto after = shared.Read();
+      REQUIRE(version == 1);
+      REQUIRE(after.Version() == 1);
+      REQUIRE(after->EdgeCount() == 1);
+      REQUIRE(after->IsNode("C"));
+    }
+    THEN("A batch that throws is not published") {
+      REQUIRE_THROWS_AS(shared.Commit([](gdwg::Graph<std::string, int>& g) {
+        g.InsertNode("D");
+        throw std::runtime_error("rejected");
+      }),
+                        std::runtime_error);
+      REQUIRE(shared.Version() == 1);
+      shared.Commit([](gdwg::Graph<std::string, int>& g) { g.InsertNode("E"); });
+      auto after = shared.Read();
+      REQUIRE_FALSE(after->IsNode("D"));
+      REQUIRE(after->IsNode("E"));
+    }
+  }
+  WHEN("One thread holds more views than there are reader slots") {
+    using Shared = gdwg::ConcurrentGraph<int, int>;
+    Shared shared{gdwg::Graph<int, int>{1}};
+    std::vector<Shared::ReadView> views;
+    for (std::size_t i = 0; i < Shared::kSlots + 8; ++i) {
+      views.push_back(shared.Read());
+    }
+    shared.Commit([](gdwg::Graph<int, int>& g) { g.InsertNode(2); });
+    auto after = shared.Read();
+    THEN("Every read returns without waiting and the old snapshot outlives the commit") {
+      REQUIRE(after.Version() == 1);
+      REQUIRE(after->NodeCount() == 2);
+      for (const auto& view : views) {
+        REQUIRE(view.Version() == 0);
+        REQUIRE(view->NodeCount() == 1);
+      }
+      views.clear();
+      shared.Commit([](gdwg::Graph<int, int>& g) { g.InsertNode(3); });
+      REQUIRE(shared.Read()->NodeCount() == 3);
+    }
+  }
+  WHEN("Readers run on other threads while a writer commits") {
+    gdwg::ConcurrentGraph<int, int> shared;
+    std::atomic<bool> done{false};
+    std::atomic<bool> consistent{true};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+      readers.emplace_back([&] {
+        while (!done.load()) {
+          // Every batch adds one node and one edge into it
+          auto view = shared.Read();
+          if (view->NodeCount() != view.Version() || view->EdgeCount() + 1 < view.Version()) {
+            consistent = false;
+          }
+        }
+      });
+    }
+    for (int i = 0; i < 200; ++i) {
+      shared.Commit([i](gdwg::Graph<int, int>& g) {
+        g.InsertNode(i);
+        if (i > 0) {
+          g.InsertEdge(i - 1, i, i);
+        }
+      });
+    }
+    done = true;
+    for (auto& reader : readers) {
+      reader.join();
+    }
+    THEN("Every snapshot a reader saw was a whole number of batches") {
+      REQUIRE(consistent);
+      REQUIRE(shared.Read()->EdgeCount() == 199);
+    }
+  }
+}
+
+SCENARIO("Applying batches") {
+  WHEN("Graph::Apply() is called with a batch of inserts and erases") {
+    using change = gdwg::Graph<std::string, int>::Mutation;
+    using op = change::Op;
+    gdwg::Graph<std::string, int> new_graph{"A", "B"};
+    new_graph.InsertEdge("A", "B", 1);
+    new_graph.InsertEdge("B", "A", 2);
+    auto changed = new_graph.Apply({{op::kInsert, "C", "A", 3},
+                                    {op::kInsert, "A", "B", 1},
+                                    {op::kErase, "B", "A", 2},
+                                    {op::kInsert, "A", "D", 4},
+                                    {op::kErase, "A", "D", 4},
+                                    {op::kErase, "A", "B", 1},
+                                    {op::kInsert, "A", "B", 1},
+                                    {op::kErase, "Z", "A", 1}});
+    THEN("The changes are applied in order for each edge and nodes are created as needed") {
+      auto e = std::vector<std::tuple<std::string, std::string, int>>{
+          std::make_tuple("A", "B", 1), std::make_tuple("C", "A", 3)};
+      gdwg::Graph<std::string, int> expected{e.begin(), e.end()};
+      expected.InsertNode("D");
+      REQUIRE(new_graph == expected);
+      REQUIRE(changed == 6);
+      REQUIRE(new_graph.GetPredecessors("A") == std::vector<std::string>{"C"});
+      REQUIRE(new_graph.GetPredecessors("D").empty());
+      REQUIRE_FALSE(new_graph.IsNode("Z"));
+    }
+  }
+}
+
+SCENARIO("Delta logs") {
+  WHEN("Batches are logged after a snapshot is saved") {
+    using change = gdwg::Graph<std::string, int>::Mutation;
+    using op = change::Op;
+    auto directory = std::filesystem::temp_directory_path();
+    auto snapshot = (directory / "gdwg_delta_log_test.bin").string();
+    auto log = (directory / "gdwg_delta_log_test.log").string();
+    std::remove(log.c_str());
+    gdwg::Graph<std::string, int> live{"A", "B"};
+    live.InsertEdge("A", "B", 1);
+    {
+      std::ofstream out{snapshot, std::ios::binary};
+      gdwg::Save(live, out);
+    }
+    std::vector<std::vector<change>> batches{
+        {{op::kInsert, "B", "C", 2}, {op::kErase, "A", "B", 1}}, {{op::kInsert, "C", "A", 3}}};
+    {
+      gdwg::DeltaLog<std::string, int> deltas{log};
+      for (const auto& batch : batches) {
+        deltas.Append(batch);
+        live.Apply(batch);
+      }
+    }
+    THEN("The snapshot plus the log rebuilds the graph") {
+      auto rebuilt = gdwg::MappedGraph<std::string, int>{snapshot}.ToGraph();
+      REQUIRE(gdwg::Replay(log, rebuilt) == 2);
+      REQUIRE(rebuilt == live);
+    }
+    THEN("A record cut short is ignored and dropped when the log is reopened") {
+      auto size = std::filesystem::file_size(log);
+      {
+        gdwg::DeltaLog<std::string, int> deltas{log};
+        deltas.Append({{op::kInsert, "A", "C", 4}});
+      }
+      std::filesystem::resize_file(log, std::filesystem::file_size(log) - 1);
+      auto rebuilt = gdwg::MappedGraph<std::string, int>{snapshot}.ToGraph();
+      REQUIRE(gdwg::Replay(log, rebuilt) == 2);
+      REQUIRE(rebuilt == live);
+
+      gdwg::DeltaLog<std::string, int> deltas{log};
+      REQUIRE(std::filesystem::file_size(log) == size);
+      deltas.Append({{op::kInsert, "A", "C", 5}});
+      REQUIRE(gdwg::Replay(log, rebuilt) == 3);
+      REQUIRE(rebuilt.IsConnected("A", "C"));
+      REQUIRE_THROWS_AS((gdwg::DeltaLog<int, int>{log}), std::runtime_error);
+    }
+    THEN("A record with a valid checksum that doesn't decode is dropped when reopened") {
+      auto size = std::filesystem::file_size(log);
+      {
+        // One change of an op that doesn't exist
+        std::string payload(sizeof(std::uint64_t) + 1, '\0');
+        payload[0] = 1;
+        payload[sizeof(std::uint64_t)] = 7;
+        std::uint64_t header[2] = {payload.size(),
+                                   gdwg::detail::Fnv1a(payload.data(), payload.size())};
+        std::ofstream out{log, std::ios::binary | std::ios::app};
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out << payload;
+      }
+      {
+        gdwg::DeltaLog<std::string, int> deltas{log};
+        REQUIRE(std::filesystem::file_size(log) == size);
+        deltas.Append({{op::kInsert, "A", "C", 4}});
+      }
+      auto rebuilt = gdwg::MappedGraph<std::string, int>{snapshot}.ToGraph();
+      REQUIRE(gdwg::Replay(log, rebuilt) == 3);
+      REQUIRE(rebuilt.IsConnected("A", "C"));
+    }
+    std::remove(snapshot.c_str());
+    std::remove(log.c_str());
+  }
+}
+
+SCENARIO("Edge ranges") {
+  WHEN("Graph::Edges() is split into parts") {
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{
+        std::make_tuple("A", "B", 1), std::make_tuple("A", "B", 2), std::make_tuple("A", "C", 3),
+        std::make_tuple("C", "A", 4), std::make_tuple("E", "A", 5)};
+    gdwg::Graph<std::string, int> new_graph{e.begin(), e.end()};
+    new_graph.InsertNode("D");
+    using edge_tuple = std::tuple<std::string, std::string, int>;
+    auto edges = new_graph.Edges();
+    THEN("The range and its parts visit the edges in iterator order") {
+      REQUIRE(std::vector<edge_tuple>(edges.begin(), edges.end()) == e);
+      REQUIRE(edges.size() == 5);
+      auto parts = edges.Split(3);
+      REQUIRE(parts.size() == 3);
+      std::vector<edge_tuple> joined;
+      for (const auto& part : parts) {
+        REQUIRE((part.size() == 1 || part.size() == 2));
+        joined.insert(joined.end(), part.begin(), part.end());
+      }
+      REQUIRE(joined == e);
+      REQUIRE(parts[0].begin().Destination() == "B");
+      REQUIRE(parts[2].begin().Source() == "C");
+
+      auto halves = parts[1].Split(2);
+      REQUIRE(halves.size() == 2);
+      REQUIRE(*halves[1].begin() == std::make_tuple("A", "C", 3));
+      REQUIRE(edges.Split(10).size() == 5);
+      REQUIRE(gdwg::Graph<std::string, int>{}.Edges().Split(4).size() == 1);
+      REQUIRE(gdwg::Graph<std::string, int>{"A"}.Edges().empty());
+    }
+    THEN("const_iterator::operator-> points at a copy of the current edge") {
+      auto arrow = new_graph.begin().operator->();
+      REQUIRE(std::get<2>(*arrow.operator->()) == 1);
+    }
+  }
+}
+
+SCENARIO("Interned graphs") {
+  WHEN("A graph is interned") {
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{
+        std::make_tuple("A", "B", 2), std::make_tuple("A", "B", 1), std::make_tuple("B", "C", 3),
+        std::make_tuple("C", "A", 4), std::make_tuple("C", "C", 5)};
+    gdwg::Graph<std::string, int> new_graph{e.begin(), e.end()};
+    new_graph.InsertNode("D");
+    gdwg::InternedGraph<std::string, int> interned{new_graph};
+    auto a = interned.Id("A");
+    auto b = interned.Id("B");
+    auto c = interned.Id("C");
+    THEN("Handles follow sorted order and the value methods match Graph") {
+      REQUIRE(static_cast<std::uint32_t>(a) == 0);
+      REQUIRE(interned.Node(c) == "C");
+      REQUIRE(interned.Id("E") == interned.npos);
+      REQUIRE(interned.NodeCount() == 4);
+      REQUIRE(interned.EdgeCount() == 5);
+      REQUIRE(interned.GetNodes() == new_graph.GetNodes());
+      REQUIRE(interned.GetConnected("A") == new_graph.GetConnected("A"));
+      REQUIRE(interned.GetWeights("A", "B") == new_graph.GetWeights("A", "B"));
+      REQUIRE(interned.IsConnected("C", "A"));
+      REQUIRE_FALSE(interned.IsConnected("A", "C"));
+      REQUIRE(interned.ToGraph() == new_graph);
+    }
+    THEN("Missing nodes print Graph's messages and the value methods return the same") {
+      std::ostringstream captured;
+      struct Restore {
+        std::streambuf* buffer;
+        ~Restore() { std::cout.rdbuf(buffer); }
+      } restore{std::cout.rdbuf(captured.rdbuf())};
+      REQUIRE(interned.InsertEdge("A", "E", 1) == new_graph.InsertEdge("A", "E", 1));
+      REQUIRE(interned.IsConnected("E", "A") == new_graph.IsConnected("E", "A"));
+      REQUIRE(interned.GetConnected("E") == new_graph.GetConnected("E"));
+      REQUIRE(interned.GetWeights("A", "E") == new_graph.GetWeights("A", "E"));
+      // Each message is printed once by InternedGraph and once by Graph
+      REQUIRE(captured.str() ==
+              "Cannot call Graph::InsertEdge when either src or dst node does not exist\n"
+              "Cannot call Graph::InsertEdge when either src or dst node does not exist\n"
+              "Cannot call Graph::IsConnected if src or dst node don't exist in the graph\n"
+              "Cannot call Graph::IsConnected if src or dst node don't exist in the graph\n"
+              "Cannot call Graph::GetConnected if src doesn't exist in the graph\n"
+              "Cannot call Graph::GetConnected if src doesn't exist in the graph\n"
+              "Cannot call Graph::GetWeights if src or dst node don't exist in the graph\n"
+              "Cannot call Graph::GetWeights if src or dst node don't exist in the graph\n");
+    }
+    THEN("Edges can be changed through handles") {
+      REQUIRE(std::vector<gdwg::NodeId>(interned.Targets(a).begin(), interned.Targets(a).end()) ==
+              std::vector<gdwg::NodeId>{b, b});
+      REQUIRE(interned.InsertEdge(a, c, 0));
+      REQUIRE_FALSE(interned.InsertEdge(a, c, 0));
+      REQUIRE(interned.Targets(a)[2] == c);
+      REQUIRE(interned.Sources(c).size() == 3);
+      REQUIRE(interned.EraseEdge(a, b, 1));
+      REQUIRE_FALSE(interned.EraseEdge(a, b, 1));
+      REQUIRE(interned.Weights(a)[0] == 2);
+      REQUIRE(interned.InDegree(b) == 1);
+      REQUIRE_THROWS_AS(interned.InsertEdge(a, interned.npos, 0), std::out_of_range);
+    }
+    THEN("Deleting a node removes its edges and retires its handle") {
+      REQUIRE(interned.DeleteNode(c));
+      REQUIRE_FALSE(interned.DeleteNode("C"));
+      REQUIRE_FALSE(interned.IsNode(c));
+      REQUIRE(interned.EdgeCount() == 2);
+      REQUIRE(interned.InDegree(a) == 0);
+      REQUIRE(interned.OutDegree(b) == 0);
+      auto again = interned.Intern("C");
+      REQUIRE(again != c);
+      REQUIRE(static_cast<std::size_t>(again) == interned.IdBound() - 1);
+      new_graph.DeleteNode("C");
+      new_graph.InsertNode("C");
+      REQUIRE(interned.ToGraph() == new_graph);
+    }
+    THEN("Handle methods throw for npos and for deleted handles") {
+      auto missing = interned.Id("E");
+      REQUIRE_THROWS_AS(interned.Node(missing), std::out_of_range);
+      REQUIRE_THROWS_AS(interned.Targets(missing), std::out_of_range);
+      REQUIRE_THROWS_AS(interned.OutDegree(missing), std::out_of_range);
+      REQUIRE_THROWS_AS(interned.EraseEdge(a, missing, 1), std::out_of_range);
+      REQUIRE_THROWS_AS(interned.DeleteNode(missing), std::out_of_range);
+      REQUIRE(interned.DeleteNode(c));
+      REQUIRE_THROWS_AS(interned.Node(c), std::out_of_range);
+      REQUIRE_THROWS_AS(interned.Weights(c), std::out_of_range);
+      REQUIRE_THROWS_AS(interned.Sources(c), std::out_of_range);
+      REQUIRE_THROWS_AS(interned.InDegree(c), std::out_of_range);
+      REQUIRE_THROWS_AS(interned.IsConnected(a, c), std::out_of_range);
+      REQUIRE_THROWS_AS(interned.DeleteNode(c), std::out_of_range);
+      REQUIRE_FALSE(interned.IsNode(missing));
+    }
+    THEN("Copies and moves keep their own value index") {
+      auto copy = interned;
+      for (int i = 0; i < 1000; ++i) {
+        interned.Intern("N" + std::to_string(i));
+      }
+      interned.DeleteNode("B");
+      REQUIRE(copy.GetNodes() == std::vector<std::string>{"A", "B", "C", "D"});
+      REQUIRE(copy.Id("B") == b);
+      REQUIRE(copy.ToGraph() == new_graph);
+      auto moved = std::move(copy);
+      REQUIRE(moved.Node(moved.Id("C")) == "C");
+      copy = moved;
+      REQUIRE(copy.Intern("E") == gdwg::NodeId{4});
+      REQUIRE(moved.Id("E") == moved.npos);
+      REQUIRE(interned.Id("N999") != interned.npos);
+      REQUIRE(interned.NodeCount() == 1003);
+    }
+  }
+}
+
+SCENARIO("Edge sets growing past the flat threshold") {
+  WHEN("A node gets more edges than fit in its array, in shuffled order") {
+    gdwg::Graph<int, int> new_graph{0, 1, 2};
+    std::vector<std::tuple<int, int, int>> expected;
+    // More than twice as many edges as fit in the array, so each dst gets to the tree as well
+    auto count = static_cast<int>(2 * gdwg::Graph<int, int>::kFlatEdges + 5);
+    std::vector<int> weights;
+    for (int w = 0; w < count; ++w) {
+      weights.push_back((w * 7) % count);
+    }
+    for (std::size_t i = 0; i < weights.size(); ++i) {
+      auto dst = static_cast<int>(i % 3);
+      REQUIRE(new_graph.InsertEdge(0, dst, weights[i]));
+      REQUIRE_FALSE(new_graph.InsertEdge(0, dst, weights[i]));
+      expected.emplace_back(0, dst, weights[i]);
+    }
+    std::sort(expected.begin(), expected.end());
+    auto to_one = static_cast<std::size_t>(std::count_if(
+        expected.begin(), expected.end(), [](const auto& edge) { return std::get<1>(edge) == 1; }));
+    THEN("The edges keep their (dst, weight) order") {
+      REQUIRE(std::vector<std::tuple<int, int, int>>(new_graph.begin(), new_graph.end()) ==
+              expected);
+      REQUIRE(new_graph.GetWeights(0, 1).size() == to_one);
+      REQUIRE(gdwg::Graph<int, int>{new_graph} == new_graph);
+    }
+    THEN("Erasing through iterators visits every edge once") {
+      std::size_t erased = 0;
+      for (auto it = new_graph.begin(); it != new_graph.end(); ++erased) {
+        it = new_graph.erase(it);
+      }
+      REQUIRE(erased == expected.size());
+      REQUIRE(new_graph.begin() == new_graph.end());
+      REQUIRE(new_graph.GetPredecessors(1).empty());
+    }
+    THEN("Merging a small edge set into a large one drops the duplicates") {
+      new_graph.InsertEdge(2, 1, 7);
+      new_graph.InsertEdge(2, 1, 100);
+      new_graph.InsertEdge(1, 2, 3);
+      new_graph.MergeReplace(2, 0);
+      REQUIRE(new_graph.GetWeights(0, 1).size() == to_one + 1);
+      REQUIRE(new_graph.GetWeights(1, 0) == std::vector<int>{3});
+      REQUIRE(new_graph.GetPredecessors(0) == std::vector<int>{0, 1});
+    }
+  }
+  WHEN("A graph of small edge sets has edges erased while iterating") {
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{
+        std::make_tuple("A", "B", 1), std::make_tuple("A", "B", 2), std::make_tuple("A", "C", 3),
+        std::make_tuple("C", "A", 4)};
+    gdwg::Graph<std::string, int> new_graph{e.begin(), e.end()};
+    THEN("erase returns the edge after the erased one") {
+      auto it = new_graph.erase(new_graph.find("A", "B", 1));
+      REQUIRE(*it == std::make_tuple("A", "B", 2));
+      it = new_graph.erase(new_graph.find("A", "C", 3));
+      REQUIRE(*it == std::make_tuple("C", "A", 4));
+      REQUIRE(new_graph.erase(it) == new_graph.end());
+    }
+  }
+}
+
+SCENARIO("Fingerprints") {
+  WHEN("A graph is changed through every mutator") {
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{
+        std::make_tuple("A", "B", 1), std::make_tuple("A", "B", 2), std::make_tuple("B", "C", 3),
+        std::make_tuple("C", "A", 4), std::make_tuple("C", "C", 5), std::make_tuple("D", "C", 6)};
+    gdwg::Graph<std::string, int> new_graph{e.begin(), e.end()};
+    // Thawing rebuilds the fingerprint from scratch
+    auto rebuilt = [&new_graph] {
+      return gdwg::Graph<std::string, int>::Thaw(new_graph.Freeze()).Fingerprint();
+    };
+    THEN("The fingerprint always matches one computed from scratch") {
+      auto original = new_graph.Fingerprint();
+      REQUIRE(original != 0);
+      REQUIRE(original == rebuilt());
+      new_graph.InsertNode("E");
+      REQUIRE(new_graph.Fingerprint() == rebuilt());
+      new_graph.InsertEdge("E", "A", 7);
+      REQUIRE(new_graph.Fingerprint() == rebuilt());
+      new_graph.erase("A", "B", 1);
+      REQUIRE(new_graph.Fingerprint() == rebuilt());
+      new_graph.Replace("C", "F");
+      REQUIRE(new_graph.Fingerprint() == rebuilt());
+      new_graph.MergeReplace("F", "A");
+      REQUIRE(new_graph.Fingerprint() == rebuilt());
+      new_graph.DeleteNode("B");
+      REQUIRE(new_graph.Fingerprint() == rebuilt());
+      using change = gdwg::Graph<std::string, int>::Mutation;
+      new_graph.Apply({{change::Op::kInsert, "G", "A", 8}, {change::Op::kErase, "E", "A", 7}});
+      REQUIRE(new_graph.Fingerprint() == rebuilt());
+      new_graph.erase(new_graph.begin());
+      REQUIRE(new_graph.Fingerprint() == rebuilt());
+      REQUIRE(new_graph.Fingerprint() != original);
+      new_graph.Clear();
+      REQUIRE(new_graph.Fingerprint() == gdwg::Graph<std::string, int>{}.Fingerprint());
+    }
+    THEN("Equal graphs built in any order share a fingerprint and different ones don't") {
+      auto reversed = std::vector<std::tuple<std::string, std::string, int>>{e.rbegin(), e.rend()};
+      gdwg::Graph<std::string, int> other;
+      for (const auto& node : {"D", "C", "B", "A"}) {
+        other.InsertNode(node);
+      }
+      for (const auto& [src, dst, weight] : reversed) {
+        other.InsertEdge(src, dst, weight);
+      }
+      REQUIRE(other.Fingerprint() == new_graph.Fingerprint());
+      REQUIRE(other == new_graph);
+      other.erase("B", "C", 3);
+      other.InsertEdge("C", "B", 3);
+      REQUIRE(other.Fingerprint() != new_graph.Fingerprint());
+      REQUIRE(other != new_graph);
+      gdwg::Graph<std::string, int> copied{new_graph};
+      gdwg::Graph<std::string, int> moved{std::move(copied)};
+      REQUIRE(moved.Fingerprint() == new_graph.Fingerprint());
+      REQUIRE(copied.Fingerprint() == 0);
+    }
+  }
+  WHEN("The node type has no std::hash") {
+    gdwg::Graph<std::pair<int, int>, int> new_graph{{1, 2}, {3, 4}};
+    new_graph.InsertEdge({1, 2}, {3, 4}, 5);
+    THEN("The fingerprint stays 0 and equality still compares the graphs") {
+      REQUIRE(new_graph.Fingerprint() == 0);
+      gdwg::Graph<std::pair<int, int>, int> other{{1, 2}, {3, 4}};
+      bool equal = other == new_graph;
+      REQUIRE_FALSE(equal);
+      other.InsertEdge({1, 2}, {3, 4}, 5);
+      equal = other == new_graph;
+      REQUIRE(equal);
+    }
+  }
+}
+
+SCENARIO("Connected components") {
+  WHEN("A graph has cycles, a bridge between them and an isolated node") {
+    // A <-> B -> C -> D -> C, E -> D, F alone
+    auto e = std::vector<std::tuple<std::string, std::string, int>>{
+        std::make_tuple("A", "B", 1), std::make_tuple("B", "A", 1), std::make_tuple("B", "C", 1),
+        std::make_tuple("C", "D", 1), std::make_tuple("D", "C", 1), std::make_tuple("E", "D", 1)};
+    gdwg::Graph<std::string, int> new_graph{e.begin(), e.end()};
+    new_graph.InsertNode("F");
+    THEN("Weak components ignore direction and are numbered by their first node") {
+      auto weak = gdwg::WeaklyConnectedComponents(new_graph);
+      REQUIRE(weak.count == 2);
+      REQUIRE(weak.component == std::vector<std::uint32_t>{0, 0, 0, 0, 0, 1});
+    }
+    THEN("Strong components need paths both ways") {
+      auto strong = gdwg::StronglyConnectedComponents(new_graph);
+      REQUIRE(strong.count == 4);
+      REQUIRE(strong.component == std::vector<std::uint32_t>{0, 0, 1, 1, 2, 3});
+    }
+    THEN("An empty graph has no components") {
+      REQUIRE(gdwg::WeaklyConnectedComponents(gdwg::Graph<int, int>{}).count == 0);
+      REQUIRE(gdwg::StronglyConnectedComponents(gdwg::Graph<int, int>{}).count == 0);
+    }
+  }
+  WHEN("A random graph is split between threads") {
+    std::vector<std::tuple<int, int, int>> edges;
+    for (int i = 0; i < 2000; ++i) {
+      edges.emplace_back((i * 7919) % 3000, (i * 104729) % 3000, 0);
+    }
+    auto frozen = gdwg::Graph<int, int>::BulkLoad(edges.begin(), edges.end()).Freeze();
+    THEN("Every thread count finds the same components") {
+      auto single = gdwg::WeaklyConnectedComponents(frozen, {1});
+      for (std::size_t threads : {2, 4, 7}) {
+        auto split = gdwg::WeaklyConnectedComponents(frozen, {threads});
+        REQUIRE(split.count == single.count);
+        REQUIRE(split.component == single.component);
+      }
+      // Every edge stays inside a component
+      std::size_t crossing = 0;
+      for (auto it = frozen.begin(); it != frozen.end(); ++it) {
+        auto dst = frozen.Id(std::get<1>(*it));
+        crossing += single.component[it.Source()] != single.component[dst];
+      }
+      REQUIRE(crossing == 0);
+    }
+  }
+  WHEN("A graph is one long cycle") {
+    const std::uint32_t n = 1000000;
+    std::vector<int> nodes(n);
+    std::vector<std::size_t> offsets(n + 1);
+    std::vector<std::uint32_t> targets(n);
+    for (std::uint32_t i = 0; i < n; ++i) {
+      nodes[i] = static_cast<int>(i);
+      offsets[i + 1] = i + 1;
+      targets[i] = (i + 1) % n;
+    }
+    gdwg::CsrGraph<int, int> frozen{nodes, offsets, targets, std::vector<int>(n)};
+    THEN("Searching it doesn't overflow the stack") {
+      REQUIRE(gdwg::StronglyConnectedComponents(frozen).count == 1);
+      targets[n - 1] = n - 1;
+      gdwg::CsrGraph<int, int> chain{nodes, offsets, targets, std::vector<int>(n)};
+      auto strong = gdwg::StronglyConnectedComponents(chain);
+      REQUIRE(strong.count == n);
+      REQUIRE(strong.component[n - 1] == n - 1);
+      REQUIRE(gdwg::WeaklyConnectedComponents(chain).count == 1);
+    }
+  }
+}
+
+SCENARIO("Parallel loops") {
+  WHEN("The body throws on some of the ranges") {
+    std::atomic<std::size_t> covered{0};
+    auto body = [&covered](std::size_t begin, std::size_t end, std::size_t thread) {
+      covered += end - begin;
+      // The calling thread runs the last range
+      if (thread == 0 || thread == 3) {
+        throw std::runtime_error("range " + std::to_string(thread));
+      }
+    };
+    THEN("Every range still runs and the first range's exception comes out") {
+      try {
+        gdwg::ParallelFor(4, 100, body);
+        FAIL("ParallelFor should have thrown");
+      } catch (const std::runtime_error& e) {
+        REQUIRE(std::string{e.what()} == "range 0");
+      }
+      REQUIRE(covered == 100);
+      REQUIRE_THROWS_AS(gdwg::ParallelFor(1, 10, body), std::runtime_error);
+    }
+  }
+}
+
+SCENARIO("PageRank") {
+  WHEN("A weighted graph has a dangling node") {
+    // A -> B (3), A -> C (1), B -> A, C -> A, C -> D, D has no edges out
+    auto e = std::vector<std::tuple<std::string, std::string, double>>{
+        std::make_tuple("A", "B", 3.0), std::make_tuple("A", "C", 1.0),
+        std::make_tuple("B", "A", 1.0), std::make_tuple("C", "A", 2.0),
+        std::make_tuple("C", "D", 2.0)};
+    gdwg::Graph<std::string, double> new_graph{e.begin(), e.end()};
+    auto frozen = new_graph.Freeze();
+    // Dense power iteration to check against
+    auto reference = [](const std::vector<double>& teleport) {
+      const double d = 0.85;
+      const double p[4][4] = {{0, 1, 0.5, 0.25}, {0.75, 0, 0, 0.25}, {0.25, 0, 0, 0.25},
+                              {0, 0, 0.5, 0.25}};
+      std::vector<double> rank(teleport);
+      for (int iteration = 0; iteration < 200; ++iteration) {
+        std::vector<double> next(4);
+        for (int v = 0; v < 4; ++v) {
+          for (int u = 0; u < 4; ++u) {
+            // The dangling node D sends its rank where teleports go
+            next[v] += d * (u == 3 ? teleport[v] : p[v][u]) * rank[u];
+          }
+          next[v] += (1 - d) * teleport[v];
+        }
+        rank = next;
+      }
+      return rank;
+    };
+    THEN("PageRank matches dense power iteration on any number of threads") {
+      auto expected = reference({0.25, 0.25, 0.25, 0.25});
+      for (std::size_t threads : {1, 3}) {
+        gdwg::PageRankOptions options;
+        options.threads = threads;
+        auto ranks = gdwg::PageRank(new_graph, options);
+        REQUIRE(ranks.converged);
+        REQUIRE(ranks.residual < options.tolerance);
+        REQUIRE(ranks.bytes_per_iteration > 0);
+        for (std::size_t v = 0; v < 4; ++v) {
+          REQUIRE(ranks.rank[v] == Approx(expected[v]).margin(1e-8));
+        }
+        REQUIRE(std::accumulate(ranks.rank.begin(), ranks.rank.end(), 0.0) == Approx(1));
+      }
+    }
+    THEN("Personalized PageRank teleports in proportion to the weights given") {
+      auto ranks = gdwg::PersonalizedPageRank(frozen, {0, 2, 0, 0});
+      auto expected = reference({0, 1, 0, 0});
+      for (std::size_t v = 0; v < 4; ++v) {
+        REQUIRE(ranks.rank[v] == Approx(expected[v]).margin(1e-8));
+      }
+      REQUIRE_THROWS_AS(gdwg::PersonalizedPageRank(frozen, {1, 1}), std::invalid_argument);
+      REQUIRE_THROWS_AS(gdwg::PersonalizedPageRank(frozen, {1, -1, 1, 1}), std::invalid_argument);
+      REQUIRE_THROWS_AS(gdwg::PersonalizedPageRank(frozen, {0, 0, 0, 0}), std::invalid_argument);
+    }
+    THEN("Iteration stops at the limit without converging") {
+      gdwg::PageRankOptions options;
+      options.max_iterations = 2;
+      auto ranks = gdwg::PageRank(frozen, options);
+      REQUIRE_FALSE(ranks.converged);
+      REQUIRE(ranks.iterations == 2);
+    }
+    THEN("Negative weights are rejected") {
+      new_graph.InsertEdge("D", "A", -1.0);
+      REQUIRE_THROWS_AS(gdwg::PageRank(new_graph), std::domain_error);
+    }
+  }
+  WHEN("The transition matrix is multiplied directly") {
+    auto e = std::vector<std::tuple<int, int, double>>{
+        std::make_tuple(0, 1, 1.0), std::make_tuple(0, 2, 3.0), std::make_tuple(1, 2, 0.0)};
+    gdwg::Graph<int, double> new_graph{e.begin(), e.end()};
+    auto matrix = gdwg::SparseMatrix::Transition(new_graph.Freeze());
+    THEN("Each edge carries its share of the source's weight") {
+      REQUIRE(matrix.Rows() == 3);
+      REQUIRE(matrix.NonZeros() == 3);
+      std::vector<double> x{4, 2, 1};
+      std::vector<double> y(3);
+      std::vector<double> bias{1, 2, 3};
+      gdwg::SpmvOptions options;
+      options.damping = 0.5;
+      options.teleport = 1;
+      options.bias = bias.data();
+      matrix.Multiply(x.data(), y.data(), options);
+      REQUIRE(y == std::vector<double>{1, 2.5, 0.5 * (3 + 2) + 3});
+    }
+  }
+}
+
+SCENARIO("Watched shortest paths") {
+  WHEN("A chain has a watched source at one end") {
+    gdwg::Graph<int, int> chain;
+    for (int i = 0; i < 1000; ++i) {
+      chain.InsertNode(i);
+    }
+    for (int i = 0; i + 1 < 1000; ++i) {
+      chain.InsertEdge(i, i + 1, 1);
+    }
+    gdwg::WatchedGraph<int, int> watched{chain};
+    REQUIRE(watched.Watch(0));
+    REQUIRE_FALSE(watched.Watch(0));
+    REQUIRE(*watched.Distance(0, 999) == 999);
+    THEN("A shortcut near the end only visits the nodes past it") {
+      REQUIRE(watched.InsertEdge(990, 995, 2));
+      REQUIRE(*watched.Distance(0, 999) == 996);
+      REQUIRE(watched.LastUpdateCost() == 5);
+      auto path = watched.PathTo(0, 996);
+      REQUIRE(path.size() == 993);
+      REQUIRE(std::vector<int>(path.end() - 3, path.end()) == std::vector<int>{990, 995, 996});
+    }
+    THEN("Cutting the chain near the end only clears the nodes past the cut") {
+      REQUIRE(watched.erase(995, 996, 1));
+      REQUIRE(watched.LastUpdateCost() == 4);
+      REQUIRE(watched.Distance(0, 996) == nullptr);
+      REQUIRE(watched.PathTo(0, 999).empty());
+      REQUIRE(*watched.Distance(0, 995) == 995);
+      // Erasing an edge off the tree changes nothing
+      REQUIRE(watched.InsertEdge(2, 4, 5));
+      REQUIRE(watched.erase(2, 4, 5));
+      REQUIRE(watched.LastUpdateCost() == 0);
+    }
+    THEN("Deleting a node reroutes around it") {
+      REQUIRE(watched.InsertEdge(497, 501, 10));
+      REQUIRE(watched.DeleteNode(499));
+      REQUIRE(*watched.Distance(0, 501) == 507);
+      REQUIRE(*watched.Distance(0, 999) == 1005);
+      // Only 499 led to 500
+      REQUIRE(watched.Distance(0, 500) == nullptr);
+      REQUIRE(watched.Paths(0).distance.size() == 998);
+      REQUIRE(watched.DeleteNode(0));
+      REQUIRE(watched.GetWatched().empty());
+    }
+    THEN("Bad calls are rejected") {
+      REQUIRE_THROWS_AS(watched.Watch(1000), std::out_of_range);
+      REQUIRE_THROWS_AS(watched.Distance(1, 2), std::out_of_range);
+      REQUIRE_THROWS_AS(watched.InsertEdge(1, 2, -1), std::domain_error);
+      chain.InsertEdge(5, 1, -1);
+      using Watched = gdwg::WatchedGraph<int, int>;
+      REQUIRE_THROWS_AS(Watched{chain}, std::domain_error);
+    }
+  }
+  WHEN("A random graph changes under two watched sources") {
+    gdwg::Graph<int, int> start;
+    for (int i = 0; i < 60; ++i) {
+      start.InsertNode(i);
+    }
+    gdwg::WatchedGraph<int, int> watched{start};
+    REQUIRE(watched.Watch(0));
+    REQUIRE(watched.Watch(30));
+    THEN("The distances always match a fresh Dijkstra") {
+      // A linear congruential generator, so the run is the same every time
+      unsigned state = 12345;
+      auto next = [&state](unsigned bound) {
+        state = state * 1103515245 + 12345;
+        return static_cast<int>((state >> 16) % bound);
+      };
+      bool matched = true;
+      for (int step = 0; step < 1500; ++step) {
+        int src = next(60);
+        int dst = next(60);
+        int w = next(10);
+        auto choice = next(10);
+        if (choice < 6) {
+          watched.InsertEdge(src, dst, w);
+        } else if (choice < 9) {
+          // Erase an edge that exists, most of the time
+          auto connected = watched.GetGraph().Adjacency().find(src);
+          if (connected != watched.GetGraph().Adjacency().end() && !connected->second.empty()) {
+            const auto& edge = **connected->second.begin();
+            watched.erase(src, std::get<0>(edge), std::get<1>(edge));
+          }
+        } else if (src != 0 && src != 30) {
+          watched.DeleteNode(src);
+          watched.InsertNode(src);
+        }
+        for (int source : {0, 30}) {
+          auto expected = gdwg::Dijkstra(watched.GetGraph(), source).distance;
+          matched = matched && watched.Paths(source).distance == expected;
+        }
+      }
+      REQUIRE(matched);
+      REQUIRE(watched.GetWatched() == std::vector<int>{0, 30});
+    }
+  }
+}
+
+SCENARIO("Instrumentation") {
+  WHEN("Every counted operation is called") {
+    gdwg::ResetInstrumentation();
+    gdwg::Graph<std::string, int> new_graph;
+    new_graph.InsertNode("a");
+    new_graph.InsertNode("b");
+    new_graph.InsertNode("c");
+    new_graph.InsertNode("c");
+    new_graph.InsertEdge("a", "b", 1);
+    new_graph.InsertEdge("a", "c", 2);
+    new_graph.InsertEdge("c", "a", 3);
+    new_graph.GetConnected("a");
+    new_graph.GetWeights("a", "b");
+    new_graph.find("a", "c", 2);
+    std::size_t edges = 0;
+    for (auto it = new_graph.begin(); it != new_graph.end(); ++it) {
+      ++edges;
+    }
+    new_graph.MergeReplace("b", "c");
+    new_graph.DeleteNode("a");
+    auto snapshot = gdwg::Instrumentation();
+    std::ostringstream prometheus;
+    gdwg::WritePrometheus(prometheus, snapshot);
+    const auto& inserts = snapshot[gdwg::Operation::kInsertNode];
+    THEN("Calls are counted only when instrumentation is compiled in") {
+      REQUIRE(edges == 3);
+      if (gdwg::kInstrumented) {
+        REQUIRE(inserts.calls == 4);
+        REQUIRE(std::accumulate(inserts.latency.begin(), inserts.latency.end(), 0ULL) == 4);
+        REQUIRE(inserts.allocations >= 3);
+        REQUIRE(snapshot[gdwg::Operation::kInsertEdge].edges_visited == 3);
+        REQUIRE(snapshot[gdwg::Operation::kGetConnected].edges_visited == 2);
+        REQUIRE(snapshot[gdwg::Operation::kFind].calls == 1);
+        REQUIRE(snapshot[gdwg::Operation::kIterate].calls == 3);
+        REQUIRE(snapshot[gdwg::Operation::kMergeReplace].edges_visited == 1);
+        // a's two edges to c, one of them moved from b, and c's edge back to a
+        REQUIRE(snapshot[gdwg::Operation::kDeleteNode].edges_visited == 3);
+      } else {
+        REQUIRE(inserts.calls == 0);
+        REQUIRE(inserts.allocations == 0);
+      }
+      std::string expected = "gdwg_graph_operation_seconds_count{operation=\"InsertNode\"} " +
+                             std::to_string(inserts.calls) + "\n";
+      REQUIRE(prometheus.str().find(expected) != std::string::npos);
+      REQUIRE(prometheus.str().find("le=\"+Inf\"") != std::string::npos);
+    }
+  }
+}
+
+SCENARIO("Synthetic graph generators") {
+  WHEN("Each generator makes a graph") {
+    auto random = gdwg::ErdosRenyi(100, 1000, 7);
+    auto skewed = gdwg::PowerLaw(1000, 20000, 2.1, 7);
+    auto grid = gdwg::Grid(10, 5);
+    THEN("They have the requested size and stay within their node ids") {
+      REQUIRE(random.edges.size() == 1000);
+      REQUIRE(skewed.edges.size() == 20000);
+      // 9 links in each of 5 rows and 4 in each of 10 columns, both ways
+      REQUIRE(grid.nodes == 50);
+      REQUIRE(grid.edges.size() == 2 * (9 * 5 + 10 * 4));
+      bool in_range = true;
+      for (const auto* generated : {&random, &skewed, &grid}) {
+        for (const auto& [src, dst, w] : generated->edges) {
+          in_range = in_range && src < generated->nodes && dst < generated->nodes && w >= 1 &&
+                     w <= 100;
+        }
+      }
+      REQUIRE(in_range);
+      REQUIRE(gdwg::ErdosRenyi(100, 1000, 7).edges == random.edges);
+    }
+    THEN("The power law graph has hubs") {
+      std::vector<std::size_t> degree(skewed.nodes);
+      for (const auto& edge : skewed.edges) {
+        ++degree[std::get<0>(edge)];
+      }
+      // Node 0 expects about a tenth of the edges, a node in the tail only a few
+      REQUIRE(degree[0] > 1000);
+      REQUIRE(degree[999] < 40);
+    }
+  }
+}
+
+SCENARIO("Non-throwing status API") {
+  WHEN("Try methods are called on good and bad input") {
+    gdwg::Graph<std::string, int> new_graph{"A", "B", "C"};
+    // Capture std::cout until the end of each section, even one that fails
+    std::ostringstream captured;
+    struct Restore {
+      std::streambuf* buffer;
+      ~Restore() { std::cout.rdbuf(buffer); }
+    } restore{std::cout.rdbuf(captured.rdbuf())};
+    THEN("They report a status for each and print nothing") {
+      REQUIRE(new_graph.TryInsertEdge("A", "B", 1) == gdwg::GraphStatus::kOk);
+      REQUIRE(new_graph.TryInsertEdge("A", "B", 1) == gdwg::GraphStatus::kExists);
+      REQUIRE(new_graph.TryInsertEdge("X", "B", 1) == gdwg::GraphStatus::kMissingSrc);
+      REQUIRE(new_graph.TryInsertEdge("A", "X", 1) == gdwg::GraphStatus::kMissingDst);
+
+      bool connected = false;
+      REQUIRE(new_graph.TryIsConnected("A", "B", connected) == gdwg::GraphStatus::kOk);
+      REQUIRE(connected);
+      REQUIRE(new_graph.TryIsConnected("B", "A", connected) == gdwg::GraphStatus::kOk);
+      REQUIRE_FALSE(connected);
+      REQUIRE(new_graph.TryIsConnected("B", "X", connected) == gdwg::GraphStatus::kMissingDst);
+
+      std::vector<std::string> nodes{"left over"};
+      REQUIRE(new_graph.TryGetConnected("A", nodes) == gdwg::GraphStatus::kOk);
+      REQUIRE(nodes == std::vector<std::string>{"B"});
+      REQUIRE(new_graph.TryGetConnected("X", nodes) == gdwg::GraphStatus::kMissingSrc);
+      REQUIRE(nodes == std::vector<std::string>{"B"});
+      std::vector<int> weights;
+      REQUIRE(new_graph.TryGetWeights("A", "B", weights) == gdwg::GraphStatus::kOk);
+      REQUIRE(weights == std::vector<int>{1});
+      REQUIRE(new_graph.TryGetWeights("A", "X", weights) == gdwg::GraphStatus::kMissingDst);
+      REQUIRE(new_graph.TryGetPredecessors("B", nodes) == gdwg::GraphStatus::kOk);
+      REQUIRE(nodes == std::vector<std::string>{"A"});
+      REQUIRE(new_graph.TryGetPredecessors("X", nodes) == gdwg::GraphStatus::kMissingDst);
+      REQUIRE(nodes == std::vector<std::string>{"A"});
+
+      REQUIRE(new_graph.TryReplace("X", "D") == gdwg::GraphStatus::kMissingSrc);
+      REQUIRE(new_graph.TryReplace("C", "A") == gdwg::GraphStatus::kExists);
+      REQUIRE(new_graph.TryReplace("C", "D") == gdwg::GraphStatus::kOk);
+      REQUIRE(new_graph.TryMergeReplace("D", "X") == gdwg::GraphStatus::kMissingDst);
+      REQUIRE(new_graph.TryMergeReplace("D", "B") == gdwg::GraphStatus::kOk);
+      REQUIRE(new_graph.GetNodes() == std::vector<std::string>{"A", "B"});
+
+      REQUIRE(new_graph.TryErase("A", "B", 2) == gdwg::GraphStatus::kMissingEdge);
+      REQUIRE(new_graph.TryErase("A", "C", 1) == gdwg::GraphStatus::kMissingDst);
+      REQUIRE(new_graph.TryErase("A", "B", 1) == gdwg::GraphStatus::kOk);
+      REQUIRE(captured.str().empty());
+    }
+    THEN("A batch gets one status per change and creates no nodes") {
+      using change = gdwg::Graph<std::string, int>::Mutation;
+      auto statuses = new_graph.TryApply({{change::Op::kInsert, "A", "B", 1},
+                                          {change::Op::kInsert, "A", "B", 1},
+                                          {change::Op::kInsert, "A", "Z", 1},
+                                          {change::Op::kErase, "A", "B", 1},
+                                          {change::Op::kErase, "A", "B", 1}});
+      REQUIRE(statuses == std::vector<gdwg::GraphStatus>{
+                              gdwg::GraphStatus::kOk, gdwg::GraphStatus::kExists,
+                              gdwg::GraphStatus::kMissingDst, gdwg::GraphStatus::kOk,
+                              gdwg::GraphStatus::kMissingEdge});
+      REQUIRE_FALSE(new_graph.IsNode("Z"));
+      REQUIRE(captured.str().empty());
+    }
+    THEN("The printing methods still print") {
+      REQUIRE_FALSE(new_graph.InsertEdge("X", "B", 1));
+      REQUIRE(captured.str() ==
+              "Cannot call Graph::InsertEdge when either src or dst node does not exist\n");
+    }
+  }
+}
+
+SCENARIO("Export") {
+  WHEN("A small graph with an isolated node and awkward names is exported") {
+    gdwg::Graph<std::string, double> new_graph{"a", "say \"hi\"", "lone"};
+    new_graph.InsertEdge("a", "say \"hi\"", 1.5);
+    new_graph.InsertEdge("a", "a", 2);
+    THEN("Each format writes every node and edge in order") {
+      std::ostringstream edges;
+      auto bytes = gdwg::Export(new_graph, edges);
+      REQUIRE(edges.str() == "a a 2\na say \"hi\" 1.5\n");
+      REQUIRE(bytes == edges.str().size());
+
+      std::ostringstream dot;
+      gdwg::Export(new_graph, dot, {gdwg::ExportFormat::kDot});
+      REQUIRE(dot.str() ==
+              "digraph {\n"
+              "  \"a\";\n"
+              "  \"a\" -> \"a\" [label=\"2\"];\n"
+              "  \"a\" -> \"say \\\"hi\\\"\" [label=\"1.5\"];\n"
+              "  \"lone\";\n"
+              "  \"say \\\"hi\\\"\";\n"
+              "}\n");
+
+      std::ostringstream json;
+      gdwg::Export(new_graph, json, {gdwg::ExportFormat::kJsonLines});
+      REQUIRE(json.str() ==
+              "{\"src\": \"a\", \"dst\": \"a\", \"weight\": 2}\n"
+              "{\"src\": \"a\", \"dst\": \"say \\\"hi\\\"\", \"weight\": 1.5}\n"
+              "{\"node\": \"lone\"}\n"
+              "{\"node\": \"say \\\"hi\\\"\"}\n");
+    }
+    THEN("operator<< writes to its stream") {
+      std::ostringstream out;
+      out << new_graph;
+      REQUIRE(out.str() == "a (\n\ta | 2\n\tsay \"hi\" | 1.5\n)\nlone (\n)\nsay \"hi\" (\n)\n");
+    }
+  }
+
+  WHEN("A larger graph is exported with several threads and small chunks") {
+    auto generated = gdwg::ErdosRenyi(2000, 20000);
+    gdwg::Graph<int, int> new_graph;
+    for (std::size_t i = 0; i < generated.nodes; ++i) {
+      new_graph.InsertNode(static_cast<int>(i));
+    }
+    for (const auto& [src, dst, w] : generated.edges) {
+      new_graph.InsertEdge(static_cast<int>(src), static_cast<int>(dst), w);
+    }
+    std::ostringstream single;
+    gdwg::Export(new_graph, single, {gdwg::ExportFormat::kJsonLines});
+
+    THEN("The output doesn't depend on the threads or chunk size") {
+      std::ostringstream chunked;
+      gdwg::Export(new_graph, chunked, {gdwg::ExportFormat::kJsonLines, 4, 1000});
+      REQUIRE(chunked.str() == single.str());
+    }
+    THEN("An edge list written to a file descriptor loads back as the same edges") {
+      auto path = (std::filesystem::temp_directory_path() / "gdwg_export_test").string();
+      int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+      REQUIRE(fd >= 0);
+      auto bytes = gdwg::Export(new_graph, fd, {gdwg::ExportFormat::kEdgeList, 3, 4096});
+      ::close(fd);
+      REQUIRE(std::filesystem::file_size(path) == bytes);
+
+      std::ifstream in{path};
+      auto loaded = gdwg::LoadEdgeList<int>(in);
+      std::remove(path.c_str());
+      std::size_t edges = 0;
+      bool same = true;
+      for (const auto& [src, dst, w] : loaded) {
+        ++edges;
+        same = same && new_graph.find(std::stoi(src), std::stoi(dst), w) != new_graph.end();
+      }
+      REQUIRE(same);
+      REQUIRE(edges == static_cast<std::size_t>(std::distance(new_graph.begin(), new_graph.end())));
+    }
+    THEN("A bad file descriptor throws") {
+      REQUIRE_THROWS_AS(gdwg::Export(new_graph, -1), std::system_error);
+    }
+  }
+}
+
+SCENARIO("Flat graph storage") {
+  WHEN("The storage is picked from the node and edge types") {
+    THEN("Small trivially copyable types get FlatGraph and the rest Graph") {
+      REQUIRE(gdwg::IsFlatStorable<int, double>::value);
+      REQUIRE_FALSE(gdwg::IsFlatStorable<std::string, int>::value);
+      REQUIRE(std::is_same_v<gdwg::CompactGraph<int, double>, gdwg::FlatGraph<int, double>>);
+      REQUIRE(std::is_same_v<gdwg::CompactGraph<std::string, int>, gdwg::Graph<std::string, int>>);
+    }
+  }
+
+  WHEN("The same random changes are made to a Graph and a FlatGraph") {
+    gdwg::Graph<int, int> graph;
+    gdwg::FlatGraph<int, int> flat;
+    std::minstd_rand rng{11};
+    auto pick = [&rng](int bound) {
+      return static_cast<int>(rng() % static_cast<unsigned>(bound));
+    };
+    bool same_status = true;
+    for (int step = 0; step < 3000; ++step) {
+      int a = pick(40);
+      int b = pick(40);
+      int w = pick(3);
+      switch (pick(10)) {
+        case 0:
+        case 1:
+          same_status = same_status && graph.InsertNode(a) == flat.InsertNode(a);
+          break;
+        case 2:
+        case 3:
+        case 4:
+          same_status = same_status && graph.TryInsertEdge(a, b, w) == flat.TryInsertEdge(a, b, w);
+          break;
+        case 5:
+        case 6:
+          same_status = same_status && graph.TryErase(a, b, w) == flat.TryErase(a, b, w);
+          break;
+        case 7:
+          same_status = same_status && graph.DeleteNode(a) == flat.DeleteNode(a);
+          break;
+        case 8:
+          same_status = same_status && graph.TryReplace(a, b) == flat.TryReplace(a, b);
+          break;
+        default:
+          same_status = same_status && graph.TryMergeReplace(a, b) == flat.TryMergeReplace(a, b);
+          break;
+      }
+    }
+    THEN("Every call reports the same and the graphs end up the same") {
+      REQUIRE(same_status);
+      std::ostringstream graph_text;
+      std::ostringstream flat_text;
+      graph_text << graph;
+      flat_text << flat;
+      REQUIRE(flat_text.str() == graph_text.str());
+      REQUIRE(std::equal(flat.rbegin(), flat.rend(), graph.rbegin(), graph.rend()));
+      auto edges = std::distance(graph.begin(), graph.end());
+      REQUIRE(flat.EdgeCount() == static_cast<std::size_t>(edges));
+      bool same_predecessors = true;
+      for (auto node : graph.GetNodes()) {
+        same_predecessors = same_predecessors &&
+                            flat.GetPredecessors(node) == graph.GetPredecessors(node) &&
+                            flat.GetConnected(node) == graph.GetConnected(node);
+      }
+      REQUIRE(same_predecessors);
+    }
+    THEN("Converting either way gives an equal graph") {
+      REQUIRE(flat.ToGraph() == graph);
+      REQUIRE(gdwg::FlatGraph<int, int>{graph} == flat);
+    }
+  }
+
+  WHEN("A FlatGraph is built from edges and changed through iterators") {
+    std::vector<std::tuple<int, int, double>> edges{
+        {3, 1, 0.5}, {1, 2, 1.5}, {3, 1, 0.5}, {1, 1, 2}};
+    gdwg::FlatGraph<int, double> flat{edges.cbegin(), edges.cend()};
+    THEN("Duplicates are dropped and both ends of each edge are nodes") {
+      REQUIRE(flat.GetNodes() == std::vector<int>{1, 2, 3});
+      REQUIRE(flat.EdgeCount() == 3);
+      REQUIRE(*flat.begin() == std::make_tuple(1, 1, 2.0));
+    }
+    THEN("erase returns the next edge, across nodes") {
+      auto it = flat.find(1, 2, 1.5);
+      REQUIRE(it != flat.end());
+      it = flat.erase(it);
+      REQUIRE(*it == std::make_tuple(3, 1, 0.5));
+      REQUIRE(flat.erase(it) == flat.end());
+      REQUIRE(flat.GetPredecessors(1) == std::vector<int>{1});
+      std::vector<int> sources;
+      REQUIRE(flat.TryGetPredecessors(9, sources) == gdwg::GraphStatus::kMissingDst);
+      REQUIRE(flat.TryGetPredecessors(1, sources) == gdwg::GraphStatus::kOk);
+      REQUIRE(sources == std::vector<int>{1});
+    }
+    THEN("Missing nodes print Graph's messages") {
+      std::ostringstream captured;
+      struct Restore {
+        std::streambuf* buffer;
+        ~Restore() { std::cout.rdbuf(buffer); }
+      } restore{std::cout.rdbuf(captured.rdbuf())};
+      REQUIRE_FALSE(flat.InsertEdge(1, 9, 1));
+      REQUIRE(captured.str() ==
+              "Cannot call Graph::InsertEdge when either src or dst node does not exist\n");
+    }
+  }
+}
+
+SCENARIO("Topological ordering") {
+  WHEN("A build graph has no cycles") {
+    gdwg::Graph<std::string, int> build{"fetch", "compile", "test", "link", "package"};
+    build.InsertEdge("fetch", "compile", 2);
+    build.InsertEdge("fetch", "test", 1);
+    build.InsertEdge("compile", "link", 5);
+    build.InsertEdge("link", "package", 1);
+    build.InsertEdge("test", "package", 10);
+    THEN("Jobs come a level at a time, each level in sorted order") {
+      REQUIRE(gdwg::TopologicalSort(build) ==
+              std::vector<std::string>{"fetch", "compile", "test", "link", "package"});
+      REQUIRE(gdwg::FindCycle(build).empty());
+    }
+    THEN("The critical path is the heaviest chain of jobs") {
+      auto path = gdwg::LongestPath(build);
+      REQUIRE(path.length == 11);
+      REQUIRE(path.nodes == std::vector<std::string>{"fetch", "test", "package"});
+    }
+    THEN("A cycle is refused and named") {
+      build.InsertEdge("package", "compile", 1);
+      REQUIRE_THROWS_AS(gdwg::TopologicalSort(build), std::domain_error);
+      REQUIRE_THROWS_AS(gdwg::LongestPath(build), std::domain_error);
+      auto cycle = gdwg::FindCycle(build);
+      REQUIRE(cycle == std::vector<std::string>{"compile", "link", "package"});
+    }
+    THEN("A self loop is a cycle of one node") {
+      build.InsertEdge("test", "test", 0);
+      REQUIRE(gdwg::FindCycle(build) == std::vector<std::string>{"test"});
+    }
+  }
+
+  WHEN("Wide levels are split between threads") {
+    // Three layers of 20000 nodes, each node with two edges into the next layer
+    constexpr int width = 20000;
+    std::vector<std::tuple<int, int, int>> edges;
+    for (int layer = 0; layer < 2; ++layer) {
+      for (int i = 0; i < width; ++i) {
+        int next = (layer + 1) * width;
+        edges.emplace_back(layer * width + i, next + i * 7 % width, 1);
+        edges.emplace_back(layer * width + i, next + (i * 13 + 5) % width, 2);
+      }
+    }
+    auto dag = gdwg::Graph<int, int>::BulkLoad(edges.begin(), edges.end());
+    auto order = gdwg::TopologicalSort(dag);
+    THEN("The order is the same as on one thread and puts every edge forward") {
+      REQUIRE(gdwg::TopologicalSort(dag, {4}) == order);
+      std::vector<std::size_t> position(order.size());
+      for (std::size_t i = 0; i < order.size(); ++i) {
+        position[static_cast<std::size_t>(order[i])] = i;
+      }
+      bool forward = true;
+      for (const auto& [src, dst, w] : dag) {
+        forward = forward && position[static_cast<std::size_t>(src)] <
+                                 position[static_cast<std::size_t>(dst)];
+      }
+      REQUIRE(forward);
+      REQUIRE(gdwg::LongestPath(dag).length == 4);
+    }
+  }
+
+  WHEN("A chain is too long to search recursively") {
+    constexpr int length = 200000;
+    std::vector<std::tuple<int, int, int>> edges;
+    for (int i = 0; i + 1 < length; ++i) {
+      edges.emplace_back(i, i + 1, 1);
+    }
+    auto chain = gdwg::Graph<int, int>::BulkLoad(edges.begin(), edges.end());
+    THEN("Every algorithm walks it without running out of stack") {
+      REQUIRE(gdwg::FindCycle(chain).empty());
+      REQUIRE(gdwg::TopologicalSort(chain).size() == static_cast<std::size_t>(length));
+      REQUIRE(gdwg::LongestPath(chain).nodes.size() == static_cast<std::size_t>(length));
+      chain.InsertEdge(length - 1, 0, 1);
+      REQUIRE(gdwg::FindCycle(chain).size() == static_cast<std::size_t>(length));
+    }
+  }
+}
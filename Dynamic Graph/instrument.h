@@ -0,0 +1,131 @@
+#ifndef ASSIGNMENTS_DG_INSTRUMENT_H_
+#define ASSIGNMENTS_DG_INSTRUMENT_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+// Instrumentation of Graph's hot paths, off unless GDWG_INSTRUMENT is defined to a non-zero
+// value before the first gdwg header is included. Every translation unit in a program must
+// agree on it. When it is off, the hooks in Graph expand to nothing and the functions below
+// report zeros, so code reading the counters builds either way.
+#ifndef GDWG_INSTRUMENT
+#define GDWG_INSTRUMENT 0
+#endif
+
+namespace gdwg {
+
+// Graph operations that are counted
+enum class Operation : std::uint8_t {
+  kInsertNode,
+  kInsertEdge,
+  kDeleteNode,
+  kMergeReplace,
+  kGetConnected,
+  kGetWeights,
+  kFind,
+  // One step of a const_iterator, either way
+  kIterate,
+};
+constexpr std::size_t kOperations = 8;
+constexpr bool kInstrumented = GDWG_INSTRUMENT != 0;
+
+// Name of op as it appears in the Prometheus labels, e.g. "InsertNode"
+const char* OperationName(Operation op);
+
+struct OperationStats {
+  // Latency bucket i counts calls that took under 2^(i + 5) ns (32 ns to about 17 ms), except
+  // the last, which counts the rest
+  static constexpr std::size_t kLatencyBuckets = 20;
+  static double BucketBound(std::size_t i) { return static_cast<double>(1ULL << (i + 5)) / 1e9; }
+
+  std::uint64_t calls = 0;
+  std::uint64_t nanoseconds = 0;
+  std::array<std::uint64_t, kLatencyBuckets> latency{};
+  // Nodes looked up or stepped over and edges read or written, over all calls
+  std::uint64_t nodes_visited = 0;
+  std::uint64_t edges_visited = 0;
+  // Allocations from graph pools (nodes, edges and container storage) made during calls
+  std::uint64_t allocations = 0;
+};
+
+// Counters of every operation since the program started or the last reset, summed over all
+// graphs and threads
+struct InstrumentationSnapshot {
+  std::array<OperationStats, kOperations> operations{};
+
+  const OperationStats& operator[](Operation op) const {
+    return operations[static_cast<std::size_t>(op)];
+  }
+};
+
+InstrumentationSnapshot Instrumentation();
+void ResetInstrumentation();
+// Writes the snapshot in the Prometheus text exposition format: a latency histogram in seconds
+// and counters of nodes, edges and allocations, each labelled by operation
+void WritePrometheus(std::ostream& os, const InstrumentationSnapshot& snapshot);
+
+namespace detail {
+
+// Shared counters, updated with relaxed atomics
+struct OperationCounters {
+  std::atomic<std::uint64_t> calls{0};
+  std::atomic<std::uint64_t> nanoseconds{0};
+  std::array<std::atomic<std::uint64_t>, OperationStats::kLatencyBuckets> latency{};
+  std::atomic<std::uint64_t> nodes_visited{0};
+  std::atomic<std::uint64_t> edges_visited{0};
+  std::atomic<std::uint64_t> allocations{0};
+};
+
+inline std::array<OperationCounters, kOperations> operation_counters;
+// Pool allocations made by this thread, which a scope reads on entry and exit
+inline thread_local std::uint64_t pool_allocations = 0;
+
+inline void CountAllocation() {
+  if constexpr (kInstrumented) {
+    ++pool_allocations;
+  }
+}
+
+// Times one call and adds it to the counters of its operation when it ends
+class OperationScope {
+ public:
+  explicit OperationScope(Operation op)
+    : op_{op}, allocations_{pool_allocations}, start_{std::chrono::steady_clock::now()} {}
+  OperationScope(const OperationScope&) = delete;
+  OperationScope& operator=(const OperationScope&) = delete;
+  ~OperationScope();
+
+  void Visit(std::size_t nodes, std::size_t edges) {
+    nodes_ += nodes;
+    edges_ += edges;
+  }
+
+ private:
+  Operation op_;
+  std::uint64_t allocations_;
+  std::chrono::steady_clock::time_point start_;
+  std::uint64_t nodes_ = 0;
+  std::uint64_t edges_ = 0;
+};
+
+}  // namespace detail
+}  // namespace gdwg
+
+// Hooks placed in Graph. GDWG_OBSERVE starts timing the enclosing block as a call of the named
+// Operation, and GDWG_VISIT adds to the nodes and edges it visited. When instrumentation is
+// off neither evaluates its arguments.
+#if GDWG_INSTRUMENT
+#define GDWG_OBSERVE(op) ::gdwg::detail::OperationScope gdwg_operation_scope{::gdwg::Operation::op}
+#define GDWG_VISIT(nodes, edges) gdwg_operation_scope.Visit((nodes), (edges))
+#else
+#define GDWG_OBSERVE(op) static_cast<void>(0)
+#define GDWG_VISIT(nodes, edges) static_cast<void>(0)
+#endif
+
+#endif  // ASSIGNMENTS_DG_INSTRUMENT_H_
+
+#include "assignments/dg/instrument.tpp"
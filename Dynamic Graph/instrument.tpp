@@ -0,0 +1,99 @@
+#ifndef ASSIGNMENTS_DG_INSTRUMENT_TPP_
+#define ASSIGNMENTS_DG_INSTRUMENT_TPP_
+
+#include "assignments/dg/instrument.h"
+
+#include <ostream>
+
+inline gdwg::detail::OperationScope::~OperationScope() {
+  auto elapsed = std::chrono::steady_clock::now() - start_;
+  auto nanoseconds = static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+  std::size_t bucket = 0;
+  while (bucket + 1 < OperationStats::kLatencyBuckets && nanoseconds >= (1ULL << (bucket + 5))) {
+    ++bucket;
+  }
+
+  auto& counters = operation_counters[static_cast<std::size_t>(op_)];
+  counters.calls.fetch_add(1, std::memory_order_relaxed);
+  counters.nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+  counters.latency[bucket].fetch_add(1, std::memory_order_relaxed);
+  counters.nodes_visited.fetch_add(nodes_, std::memory_order_relaxed);
+  counters.edges_visited.fetch_add(edges_, std::memory_order_relaxed);
+  counters.allocations.fetch_add(pool_allocations - allocations_, std::memory_order_relaxed);
+}
+
+inline const char* gdwg::OperationName(Operation op) {
+  static constexpr const char* names[kOperations] = {
+      "InsertNode",   "InsertEdge", "DeleteNode", "MergeReplace",
+      "GetConnected", "GetWeights", "find",       "iterate"};
+  return names[static_cast<std::size_t>(op)];
+}
+
+inline gdwg::InstrumentationSnapshot gdwg::Instrumentation() {
+  InstrumentationSnapshot snapshot;
+  for (std::size_t op = 0; op < kOperations; ++op) {
+    const auto& counters = detail::operation_counters[op];
+    auto& stats = snapshot.operations[op];
+    stats.calls = counters.calls.load(std::memory_order_relaxed);
+    stats.nanoseconds = counters.nanoseconds.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < OperationStats::kLatencyBuckets; ++i) {
+      stats.latency[i] = counters.latency[i].load(std::memory_order_relaxed);
+    }
+    stats.nodes_visited = counters.nodes_visited.load(std::memory_order_relaxed);
+    stats.edges_visited = counters.edges_visited.load(std::memory_order_relaxed);
+    stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+inline void gdwg::ResetInstrumentation() {
+  for (auto& counters : detail::operation_counters) {
+    counters.calls.store(0, std::memory_order_relaxed);
+    counters.nanoseconds.store(0, std::memory_order_relaxed);
+    for (auto& bucket : counters.latency) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    counters.nodes_visited.store(0, std::memory_order_relaxed);
+    counters.edges_visited.store(0, std::memory_order_relaxed);
+    counters.allocations.store(0, std::memory_order_relaxed);
+  }
+}
+
+inline void gdwg::WritePrometheus(std::ostream& os, const InstrumentationSnapshot& snapshot) {
+  os << "# HELP gdwg_graph_operation_seconds Latency of gdwg::Graph operations.\n"
+     << "# TYPE gdwg_graph_operation_seconds histogram\n";
+  for (std::size_t op = 0; op < kOperations; ++op) {
+    const auto& stats = snapshot.operations[op];
+    const char* name = OperationName(static_cast<Operation>(op));
+    // Prometheus buckets are cumulative
+    std::uint64_t below = 0;
+    for (std::size_t i = 0; i + 1 < OperationStats::kLatencyBuckets; ++i) {
+      below += stats.latency[i];
+      os << "gdwg_graph_operation_seconds_bucket{operation=\"" << name << "\",le=\""
+         << OperationStats::BucketBound(i) << "\"} " << below << '\n';
+    }
+    os << "gdwg_graph_operation_seconds_bucket{operation=\"" << name << "\",le=\"+Inf\"} "
+       << stats.calls << '\n'
+       << "gdwg_graph_operation_seconds_sum{operation=\"" << name << "\"} "
+       << static_cast<double>(stats.nanoseconds) / 1e9 << '\n'
+       << "gdwg_graph_operation_seconds_count{operation=\"" << name << "\"} " << stats.calls
+       << '\n';
+  }
+
+  auto counter = [&os, &snapshot](const char* metric, const char* help, auto field) {
+    os << "# HELP " << metric << ' ' << help << '\n' << "# TYPE " << metric << " counter\n";
+    for (std::size_t op = 0; op < kOperations; ++op) {
+      os << metric << "{operation=\"" << OperationName(static_cast<Operation>(op)) << "\"} "
+         << snapshot.operations[op].*field << '\n';
+    }
+  };
+  counter("gdwg_graph_nodes_visited_total", "Nodes looked up or stepped over.",
+          &OperationStats::nodes_visited);
+  counter("gdwg_graph_edges_visited_total", "Edges read or written.",
+          &OperationStats::edges_visited);
+  counter("gdwg_graph_allocations_total", "Allocations from graph pools.",
+          &OperationStats::allocations);
+}
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef ASSIGNMENTS_DG_INTERNED_GRAPH_H_
+#define ASSIGNMENTS_DG_INTERNED_GRAPH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <map>
+#include <vector>
+
+#include "assignments/dg/csr_graph.h"
+#include "assignments/dg/graph.h"
+
+namespace gdwg {
+
+// Handle to a node of an InternedGraph. A distinct type rather than an integer, so the handle
+// and value overloads never collide, even for integer node types.
+enum class NodeId : std::uint32_t {};
+
+// A mutable graph whose nodes are interned: each node value is stored once and given a 32 bit
+// handle, and the edges are kept as sorted arrays of handles.
+// Hot loops work on handles and never compare node values. A node's handle stays the same
+// until the node is deleted and is never given to another node, so handles can index arrays
+// sized by IdBound(). As handles aren't reused, each node ever inserted keeps an emptied slot
+// after it is deleted, until Clear().
+// The value methods mirror Graph's and translate each value to its handle with one lookup.
+// Like Graph, they print Graph's message and return what Graph does when a node doesn't exist.
+// Every handle method other than IsNode throws std::out_of_range if the handle isn't a node
+// of the graph, whether it is npos, was never given out or belongs to a deleted node.
+template <typename N, typename E>
+class InternedGraph {
+ public:
+  template <typename T>
+  using span = typename CsrGraph<N, E>::template span<T>;
+  static constexpr NodeId npos = NodeId{std::numeric_limits<std::uint32_t>::max()};
+
+  // Constructors
+  InternedGraph() = default;
+  // Handles are given in sorted order, so they match the frozen graph's node ids
+  explicit InternedGraph(const CsrGraph<N, E>& frozen);
+  explicit InternedGraph(const Graph<N, E>& graph) : InternedGraph{graph.Freeze()} {}
+  // The value index points into the values, so a copy builds its own
+  InternedGraph(const InternedGraph& other);
+  InternedGraph(InternedGraph&&) = default;
+
+  // Operations
+  InternedGraph& operator=(const InternedGraph& other);
+  InternedGraph& operator=(InternedGraph&&) = default;
+
+  // Handle methods
+  // Returns the node's handle, inserting the node first if it isn't in the graph
+  NodeId Intern(const N& val);
+  // Returns npos if the node isn't in the graph
+  NodeId Id(const N& val) const;
+  const N& Node(NodeId id) const { return values_[Checked(id, "Node")]; }
+  bool IsNode(NodeId id) const { return Index(id) < nodes_.size() && nodes_[Index(id)].live; }
+  bool InsertEdge(NodeId src, NodeId dst, const E& w);
+  // Returns false only if the edge isn't there
+  bool EraseEdge(NodeId src, NodeId dst, const E& w);
+  bool DeleteNode(NodeId id);
+  bool IsConnected(NodeId src, NodeId dst) const;
+  // Edges out of a node, sorted by (dst handle, weight)
+  std::size_t OutDegree(NodeId id) const { return nodes_[Checked(id, "OutDegree")].targets.size(); }
+  span<NodeId> Targets(NodeId id) const;
+  span<E> Weights(NodeId id) const;
+  // Sources of the edges into a node, one per edge, in ascending order
+  std::size_t InDegree(NodeId id) const { return nodes_[Checked(id, "InDegree")].sources.size(); }
+  span<NodeId> Sources(NodeId id) const;
+  std::size_t NodeCount() const { return ids_.size(); }
+  std::size_t EdgeCount() const { return edges_; }
+  // One more than the largest handle given out so far
+  std::size_t IdBound() const { return nodes_.size(); }
+
+  // Value methods
+  bool InsertNode(const N& val);
+  bool InsertEdge(const N& src, const N& dst, const E& w);
+  bool DeleteNode(const N& val);
+  void Clear();
+  bool IsNode(const N& val) const { return ids_.find(val) != ids_.end(); }
+  bool IsConnected(const N& src, const N& dst) const;
+  std::vector<N> GetNodes() const;
+  std::vector<N> GetConnected(const N& src) const;
+  std::vector<E> GetWeights(const N& src, const N& dst) const;
+  bool erase(const N& src, const N& dst, const E& w);
+  Graph<N, E> ToGraph() const;
+
+ private:
+  struct Adjacency {
+    std::vector<NodeId> targets;
+    std::vector<E> weights;
+    std::vector<NodeId> sources;
+    bool live = true;
+  };
+
+  // Orders the value index by the values pointed to. Transparent so it is searched by value.
+  struct ValueLess {
+    using is_transparent = void;
+
+    bool operator()(const N* lhs, const N* rhs) const { return *lhs < *rhs; }
+    bool operator()(const N* lhs, const N& rhs) const { return *lhs < rhs; }
+    bool operator()(const N& lhs, const N* rhs) const { return lhs < *rhs; }
+  };
+
+  // Values by handle. A deque, so appending never moves the values ids_ points to. A deleted
+  // node's value is reset to N{} to free what it held.
+  std::deque<N> values_;
+  std::vector<Adjacency> nodes_;
+  // Handles of the live nodes, keyed by their values in values_
+  std::map<const N*, NodeId, ValueLess> ids_;
+  std::size_t edges_ = 0;
+
+  static std::size_t Index(NodeId id) { return static_cast<std::size_t>(id); }
+  // Index of a live node's handle, throwing std::out_of_range naming the method otherwise
+  std::size_t Checked(NodeId id, const char* method) const;
+  // Position of the first edge out of node at or after (dst, w)
+  std::size_t LowerBound(const Adjacency& node, NodeId dst, const E& w) const;
+  // Removes every edge from src to dst, without touching dst's sources
+  void EraseTargets(NodeId src, NodeId dst);
+};
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_INTERNED_GRAPH_H_
+
+#include "assignments/dg/interned_graph.tpp"
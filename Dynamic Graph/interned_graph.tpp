@@ -0,0 +1,311 @@
+#ifndef ASSIGNMENTS_DG_INTERNED_GRAPH_TPP_
+#define ASSIGNMENTS_DG_INTERNED_GRAPH_TPP_
+
+#include "assignments/dg/interned_graph.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+
+// Begin constructors
+template <typename N, typename E>
+gdwg::InternedGraph<N, E>::InternedGraph(const CsrGraph<N, E>& frozen)
+  : values_(frozen.Nodes().begin(), frozen.Nodes().end()), nodes_(frozen.NodeCount()),
+    edges_{frozen.EdgeCount()} {
+  // The frozen graph's ids are positions in sorted order and its edges are sorted by
+  // (dst id, weight), which is the order kept here, so the arrays are copied as they are
+  for (std::size_t i = 0; i < values_.size(); ++i) {
+    auto id = static_cast<std::uint32_t>(i);
+    auto targets = frozen.Targets(id);
+    auto weights = frozen.Weights(id);
+    auto sources = frozen.Sources(id);
+    auto& node = nodes_[i];
+    node.targets.reserve(targets.size());
+    for (auto dst : targets) {
+      node.targets.push_back(NodeId{dst});
+    }
+    node.weights.assign(weights.begin(), weights.end());
+    node.sources.reserve(sources.size());
+    for (auto src : sources) {
+      node.sources.push_back(NodeId{src});
+    }
+    ids_.emplace_hint(ids_.end(), &values_[i], NodeId{id});
+  }
+}
+
+template <typename N, typename E>
+gdwg::InternedGraph<N, E>::InternedGraph(const InternedGraph& other)
+  : values_{other.values_}, nodes_{other.nodes_}, edges_{other.edges_} {
+  for (const auto& entry : other.ids_) {
+    ids_.emplace_hint(ids_.end(), &values_[Index(entry.second)], entry.second);
+  }
+}
+// end constructors
+
+template <typename N, typename E>
+gdwg::InternedGraph<N, E>& gdwg::InternedGraph<N, E>::operator=(const InternedGraph& other) {
+  if (this != &other) {
+    *this = InternedGraph{other};
+  }
+  return *this;
+}
+
+template <typename N, typename E>
+gdwg::NodeId gdwg::InternedGraph<N, E>::Intern(const N& val) {
+  auto search = ids_.lower_bound(val);
+  if (search != ids_.end() && !(val < *search->first)) {
+    return search->second;
+  }
+  auto id = NodeId{static_cast<std::uint32_t>(nodes_.size())};
+  values_.push_back(val);
+  nodes_.emplace_back();
+  ids_.emplace_hint(search, &values_.back(), id);
+  return id;
+}
+
+template <typename N, typename E>
+gdwg::NodeId gdwg::InternedGraph<N, E>::Id(const N& val) const {
+  auto search = ids_.find(val);
+  return search == ids_.end() ? npos : search->second;
+}
+
+template <typename N, typename E>
+bool gdwg::InternedGraph<N, E>::InsertEdge(NodeId src, NodeId dst, const E& w) {
+  Checked(dst, "InsertEdge");
+  auto& node = nodes_[Checked(src, "InsertEdge")];
+  auto position = LowerBound(node, dst, w);
+  if (position < node.targets.size() && node.targets[position] == dst &&
+      !(w < node.weights[position])) {
+    return false;
+  }
+  node.targets.insert(node.targets.begin() + position, dst);
+  node.weights.insert(node.weights.begin() + position, w);
+  auto& sources = nodes_[Index(dst)].sources;
+  sources.insert(std::upper_bound(sources.begin(), sources.end(), src), src);
+  ++edges_;
+  return true;
+}
+
+template <typename N, typename E>
+bool gdwg::InternedGraph<N, E>::EraseEdge(NodeId src, NodeId dst, const E& w) {
+  Checked(dst, "EraseEdge");
+  auto& node = nodes_[Checked(src, "EraseEdge")];
+  auto position = LowerBound(node, dst, w);
+  if (position == node.targets.size() || node.targets[position] != dst ||
+      w < node.weights[position]) {
+    return false;
+  }
+  node.targets.erase(node.targets.begin() + position);
+  node.weights.erase(node.weights.begin() + position);
+  auto& sources = nodes_[Index(dst)].sources;
+  sources.erase(std::lower_bound(sources.begin(), sources.end(), src));
+  --edges_;
+  return true;
+}
+
+template <typename N, typename E>
+bool gdwg::InternedGraph<N, E>::DeleteNode(NodeId id) {
+  auto& node = nodes_[Checked(id, "DeleteNode")];
+  // Each neighbour is visited once, however many edges it shares with the node
+  auto self_loops = std::size_t{0};
+  for (auto it = node.sources.begin(); it != node.sources.end();) {
+    auto src = *it;
+    it = std::upper_bound(it, node.sources.end(), src);
+    if (src == id) {
+      self_loops = static_cast<std::size_t>(
+          it - std::lower_bound(node.sources.begin(), it, src));
+    } else {
+      EraseTargets(src, id);
+    }
+  }
+  for (auto it = node.targets.begin(); it != node.targets.end();) {
+    auto dst = *it;
+    it = std::upper_bound(it, node.targets.end(), dst);
+    if (dst != id) {
+      auto& sources = nodes_[Index(dst)].sources;
+      auto range = std::equal_range(sources.begin(), sources.end(), id);
+      sources.erase(range.first, range.second);
+    }
+  }
+  edges_ -= node.targets.size() + node.sources.size() - self_loops;
+  node = Adjacency{};
+  node.live = false;
+  ids_.erase(&values_[Index(id)]);
+  values_[Index(id)] = N{};
+  return true;
+}
+
+template <typename N, typename E>
+bool gdwg::InternedGraph<N, E>::IsConnected(NodeId src, NodeId dst) const {
+  Checked(dst, "IsConnected");
+  const auto& targets = nodes_[Checked(src, "IsConnected")].targets;
+  return std::binary_search(targets.begin(), targets.end(), dst);
+}
+
+template <typename N, typename E>
+typename gdwg::InternedGraph<N, E>::template span<gdwg::NodeId>
+gdwg::InternedGraph<N, E>::Targets(NodeId id) const {
+  const auto& targets = nodes_[Checked(id, "Targets")].targets;
+  return span<NodeId>{targets.data(), targets.size()};
+}
+
+template <typename N, typename E>
+typename gdwg::InternedGraph<N, E>::template span<E>
+gdwg::InternedGraph<N, E>::Weights(NodeId id) const {
+  const auto& weights = nodes_[Checked(id, "Weights")].weights;
+  return span<E>{weights.data(), weights.size()};
+}
+
+template <typename N, typename E>
+typename gdwg::InternedGraph<N, E>::template span<gdwg::NodeId>
+gdwg::InternedGraph<N, E>::Sources(NodeId id) const {
+  const auto& sources = nodes_[Checked(id, "Sources")].sources;
+  return span<NodeId>{sources.data(), sources.size()};
+}
+
+template <typename N, typename E>
+bool gdwg::InternedGraph<N, E>::InsertNode(const N& val) {
+  auto count = ids_.size();
+  Intern(val);
+  return ids_.size() != count;
+}
+
+template <typename N, typename E>
+bool gdwg::InternedGraph<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
+  auto src_id = Id(src);
+  auto dst_id = Id(dst);
+  if (src_id == npos || dst_id == npos) {
+    std::cout << "Cannot call Graph::InsertEdge when either src or dst node does not exist\n";
+    return false;
+  }
+  return InsertEdge(src_id, dst_id, w);
+}
+
+template <typename N, typename E>
+bool gdwg::InternedGraph<N, E>::DeleteNode(const N& val) {
+  auto id = Id(val);
+  return id != npos && DeleteNode(id);
+}
+
+template <typename N, typename E>
+void gdwg::InternedGraph<N, E>::Clear() {
+  values_.clear();
+  nodes_.clear();
+  ids_.clear();
+  edges_ = 0;
+}
+
+template <typename N, typename E>
+bool gdwg::InternedGraph<N, E>::IsConnected(const N& src, const N& dst) const {
+  auto src_id = Id(src);
+  auto dst_id = Id(dst);
+  if (src_id == npos || dst_id == npos) {
+    // Graph has always reported a missing node as connected, after the message
+    std::cout << "Cannot call Graph::IsConnected if src or dst node don't exist in the graph\n";
+    return true;
+  }
+  return IsConnected(src_id, dst_id);
+}
+
+template <typename N, typename E>
+std::vector<N> gdwg::InternedGraph<N, E>::GetNodes() const {
+  std::vector<N> nodes;
+  nodes.reserve(ids_.size());
+  for (const auto& entry : ids_) {
+    nodes.push_back(*entry.first);
+  }
+  return nodes;
+}
+
+template <typename N, typename E>
+std::vector<N> gdwg::InternedGraph<N, E>::GetConnected(const N& src) const {
+  // One entry per edge, in value order like Graph::GetConnected
+  std::vector<N> connected;
+  auto src_id = Id(src);
+  if (src_id == npos) {
+    std::cout << "Cannot call Graph::GetConnected if src doesn't exist in the graph\n";
+    return connected;
+  }
+  const auto& targets = nodes_[Index(src_id)].targets;
+  connected.reserve(targets.size());
+  for (auto dst : targets) {
+    connected.push_back(values_[Index(dst)]);
+  }
+  std::sort(connected.begin(), connected.end());
+  return connected;
+}
+
+template <typename N, typename E>
+std::vector<E> gdwg::InternedGraph<N, E>::GetWeights(const N& src, const N& dst) const {
+  auto src_id = Id(src);
+  auto dst_id = Id(dst);
+  if (src_id == npos || dst_id == npos) {
+    std::cout << "Cannot call Graph::GetWeights if src or dst node don't exist in the graph\n";
+    return {};
+  }
+  const auto& node = nodes_[Index(src_id)];
+  auto range = std::equal_range(node.targets.begin(), node.targets.end(), dst_id);
+  auto first = node.weights.begin() + (range.first - node.targets.begin());
+  auto last = node.weights.begin() + (range.second - node.targets.begin());
+  return std::vector<E>(first, last);
+}
+
+template <typename N, typename E>
+bool gdwg::InternedGraph<N, E>::erase(const N& src, const N& dst, const E& w) {
+  auto src_id = Id(src);
+  auto dst_id = Id(dst);
+  return src_id != npos && dst_id != npos && EraseEdge(src_id, dst_id, w);
+}
+
+template <typename N, typename E>
+gdwg::Graph<N, E> gdwg::InternedGraph<N, E>::ToGraph() const {
+  std::vector<std::tuple<N, N, E>> edges;
+  edges.reserve(edges_);
+  for (const auto& entry : ids_) {
+    const auto& node = nodes_[Index(entry.second)];
+    for (std::size_t i = 0; i < node.targets.size(); ++i) {
+      edges.emplace_back(*entry.first, values_[Index(node.targets[i])], node.weights[i]);
+    }
+  }
+  auto graph = Graph<N, E>::BulkLoad(std::make_move_iterator(edges.begin()),
+                                     std::make_move_iterator(edges.end()));
+  for (const auto& entry : ids_) {
+    if (nodes_[Index(entry.second)].targets.empty()) {
+      graph.InsertNode(*entry.first);
+    }
+  }
+  return graph;
+}
+
+template <typename N, typename E>
+std::size_t gdwg::InternedGraph<N, E>::Checked(NodeId id, const char* method) const {
+  if (!IsNode(id)) {
+    throw std::out_of_range(std::string{"Cannot call InternedGraph::"} + method +
+                            " on a handle that isn't a node of the graph");
+  }
+  return Index(id);
+}
+
+template <typename N, typename E>
+std::size_t
+gdwg::InternedGraph<N, E>::LowerBound(const Adjacency& node, NodeId dst, const E& w) const {
+  auto range = std::equal_range(node.targets.begin(), node.targets.end(), dst);
+  auto first = node.weights.begin() + (range.first - node.targets.begin());
+  auto last = node.weights.begin() + (range.second - node.targets.begin());
+  return static_cast<std::size_t>(std::lower_bound(first, last, w) - node.weights.begin());
+}
+
+template <typename N, typename E>
+void gdwg::InternedGraph<N, E>::EraseTargets(NodeId src, NodeId dst) {
+  auto& node = nodes_[Index(src)];
+  auto range = std::equal_range(node.targets.begin(), node.targets.end(), dst);
+  auto first = range.first - node.targets.begin();
+  auto last = range.second - node.targets.begin();
+  node.targets.erase(range.first, range.second);
+  node.weights.erase(node.weights.begin() + first, node.weights.begin() + last);
+}
+
+#endif
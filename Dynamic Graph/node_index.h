@@ -0,0 +1,48 @@
+#ifndef ASSIGNMENTS_DG_NODE_INDEX_H_
+#define ASSIGNMENTS_DG_NODE_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace gdwg {
+namespace detail {
+
+// A Graph's nodes numbered in map order, which is sorted order, with every edge's target looked
+// up once. Map is Graph::node_map. nodes[v] is node v's map entry, and its edges are at
+// [offsets[v], offsets[v + 1]) of targets in the order of its edge set, so weights are read
+// from the entry and no node value is copied. Ids fit CsrGraph's node_id.
+template <typename Map>
+struct NodeIndex {
+  using node_type = typename Map::key_type::element_type;
+
+  std::vector<typename Map::const_iterator> nodes;
+  std::vector<std::size_t> offsets;
+  std::vector<std::uint32_t> targets;
+
+  explicit NodeIndex(const Map& adjacency) {
+    // An edge's target refers to the node stored as the key of the target's entry
+    std::unordered_map<const node_type*, std::uint32_t> ids;
+    ids.reserve(adjacency.size());
+    nodes.reserve(adjacency.size());
+    for (auto it = adjacency.begin(); it != adjacency.end(); ++it) {
+      ids.emplace(it->first.get(), static_cast<std::uint32_t>(nodes.size()));
+      nodes.push_back(it);
+    }
+    offsets.reserve(nodes.size() + 1);
+    offsets.push_back(0);
+    for (const auto& node : nodes) {
+      for (const auto& edge : node->second) {
+        targets.push_back(ids.find(&std::get<0>(*edge))->second);
+      }
+      offsets.push_back(targets.size());
+    }
+  }
+};
+
+}  // namespace detail
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_NODE_INDEX_H_
@@ -0,0 +1,75 @@
+#ifndef ASSIGNMENTS_DG_PAGERANK_H_
+#define ASSIGNMENTS_DG_PAGERANK_H_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/csr_graph.h"
+#include "assignments/dg/graph.h"
+#include "assignments/dg/sparse_matrix.h"
+
+namespace gdwg {
+
+struct PageRankOptions {
+  // Chance of following an edge rather than teleporting
+  double damping = 0.85;
+  // Stop once an iteration moves the ranks less than this in total (L1 distance)
+  double tolerance = 1e-9;
+  std::size_t max_iterations = 100;
+  // 0 uses one thread per hardware thread
+  std::size_t threads = 0;
+};
+
+struct PageRankResult {
+  // Rank of each node id. The ranks sum to 1.
+  std::vector<double> rank;
+  std::size_t iterations = 0;
+  // L1 distance moved by the last iteration
+  double residual = 0;
+  bool converged = false;
+  // Time spent iterating, and the bytes each iteration reads and writes, counting each pass
+  // over the matrix or a vector once
+  double seconds = 0;
+  std::size_t bytes_per_iteration = 0;
+
+  double IterationsPerSecond() const { return seconds > 0 ? iterations / seconds : 0; }
+  double GigabytesPerSecond() const {
+    return seconds > 0 ? iterations * static_cast<double>(bytes_per_iteration) / 1e9 / seconds
+                       : 0;
+  }
+};
+
+// PageRank by power iteration over the graph's transition matrix, weighting each edge out of
+// a node by its share of the node's total weight. Teleports, and the rank of nodes without
+// edges out, are spread evenly over all nodes.
+// Throws std::domain_error if a weight is negative.
+template <typename N, typename E>
+PageRankResult PageRank(const CsrGraph<N, E>& g, const PageRankOptions& options = {});
+
+// PageRank that teleports to nodes in proportion to personalization, which holds a
+// non-negative weight for each node id and is normalized to sum to 1.
+// Throws std::invalid_argument if personalization has the wrong size, a negative entry or no
+// positive one, and std::domain_error if a weight is negative.
+template <typename N, typename E>
+PageRankResult PersonalizedPageRank(const CsrGraph<N, E>& g,
+                                    std::vector<double> personalization,
+                                    const PageRankOptions& options = {});
+
+// The same over a Graph, which is frozen first. Node ids are positions in GetNodes() order.
+template <typename N, typename E>
+PageRankResult PageRank(const Graph<N, E>& g, const PageRankOptions& options = {}) {
+  return PageRank(g.Freeze(), options);
+}
+template <typename N, typename E>
+PageRankResult PersonalizedPageRank(const Graph<N, E>& g,
+                                    std::vector<double> personalization,
+                                    const PageRankOptions& options = {}) {
+  return PersonalizedPageRank(g.Freeze(), std::move(personalization), options);
+}
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_PAGERANK_H_
+
+#include "assignments/dg/pagerank.tpp"
@@ -0,0 +1,120 @@
+#ifndef ASSIGNMENTS_DG_PAGERANK_TPP_
+#define ASSIGNMENTS_DG_PAGERANK_TPP_
+
+#include "assignments/dg/pagerank.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+
+#include "assignments/dg/parallel.h"
+
+namespace gdwg {
+namespace detail {
+
+// Power iteration shared by both PageRanks. An empty personalization teleports uniformly.
+template <typename N, typename E>
+PageRankResult PowerIterate(const CsrGraph<N, E>& g,
+                            const std::vector<double>& personalization,
+                            const PageRankOptions& options) {
+  PageRankResult result;
+  const std::size_t n = g.NodeCount();
+  if (n == 0) {
+    result.converged = true;
+    return result;
+  }
+  const std::size_t threads = options.threads == 0 ? DefaultThreads() : options.threads;
+  const bool uniform = personalization.empty();
+  auto matrix = SparseMatrix::Transition(g);
+  std::vector<std::uint32_t> dangling;
+  for (std::uint32_t v = 0; v < n; ++v) {
+    if (g.OutDegree(v) == 0) {
+      dangling.push_back(v);
+    }
+  }
+
+  // One SpMV pass, the rank vectors in the residual pass, and the dangling nodes' ranks
+  result.bytes_per_iteration = matrix.Bytes() + 4 * n * sizeof(double) +
+                               (uniform ? 0 : n * sizeof(double)) +
+                               dangling.size() * (sizeof(std::uint32_t) + sizeof(double));
+
+  std::vector<double> rank = uniform ? std::vector<double>(n, 1.0 / n) : personalization;
+  std::vector<double> next(n);
+  std::vector<double> partial(std::min(threads, n));
+  auto start = std::chrono::steady_clock::now();
+  while (result.iterations < options.max_iterations) {
+    // Rank held by dangling nodes has nowhere to go, so it teleports along with the rest
+    double stuck = 0;
+    for (auto v : dangling) {
+      stuck += rank[v];
+    }
+    SpmvOptions spmv;
+    spmv.threads = threads;
+    spmv.damping = options.damping;
+    spmv.teleport = (1 - options.damping) + options.damping * stuck;
+    if (uniform) {
+      spmv.teleport /= static_cast<double>(n);
+    } else {
+      spmv.bias = personalization.data();
+    }
+    matrix.Multiply(rank.data(), next.data(), spmv);
+
+    ParallelFor(partial.size(), n, [&](std::size_t begin, std::size_t end, std::size_t t) {
+      double moved = 0;
+      for (auto v = begin; v < end; ++v) {
+        moved += std::abs(next[v] - rank[v]);
+      }
+      partial[t] = moved;
+    });
+    result.residual = std::accumulate(partial.begin(), partial.end(), 0.0);
+    rank.swap(next);
+    ++result.iterations;
+    if (result.residual < options.tolerance) {
+      result.converged = true;
+      break;
+    }
+  }
+  result.seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  result.rank = std::move(rank);
+  return result;
+}
+
+}  // namespace detail
+}  // namespace gdwg
+
+template <typename N, typename E>
+gdwg::PageRankResult gdwg::PageRank(const CsrGraph<N, E>& g, const PageRankOptions& options) {
+  return detail::PowerIterate(g, {}, options);
+}
+
+template <typename N, typename E>
+gdwg::PageRankResult gdwg::PersonalizedPageRank(const CsrGraph<N, E>& g,
+                                                std::vector<double> personalization,
+                                                const PageRankOptions& options) {
+  if (personalization.size() != g.NodeCount()) {
+    throw std::invalid_argument(
+        "Cannot call gdwg::PersonalizedPageRank without one weight per node");
+  }
+  double total = 0;
+  for (auto weight : personalization) {
+    if (weight < 0) {
+      throw std::invalid_argument(
+          "Cannot call gdwg::PersonalizedPageRank with a negative personalization weight");
+    }
+    total += weight;
+  }
+  if (!(total > 0)) {
+    throw std::invalid_argument(
+        "Cannot call gdwg::PersonalizedPageRank without a positive personalization weight");
+  }
+  for (auto& weight : personalization) {
+    weight /= total;
+  }
+  return detail::PowerIterate(g, personalization, options);
+}
+
+#endif
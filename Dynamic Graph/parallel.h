@@ -0,0 +1,57 @@
+#ifndef ASSIGNMENTS_DG_PARALLEL_H_
+#define ASSIGNMENTS_DG_PARALLEL_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace gdwg {
+
+// Number of threads to use when the caller asks for 0
+inline std::size_t DefaultThreads() {
+  return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+// Splits [0, n) into at most threads contiguous ranges of near equal size and calls
+// f(begin, end, thread) for each one. The last range runs on the calling thread.
+// If any call throws, every range still finishes, and then the exception from the lowest
+// thread is rethrown.
+template <typename F>
+void ParallelFor(std::size_t threads, std::size_t n, F f) {
+  threads = std::max<std::size_t>(1, std::min(threads, n));
+  std::vector<std::exception_ptr> errors(threads);
+  auto run = [&f, &errors](std::size_t begin, std::size_t end, std::size_t t) {
+    try {
+      f(begin, end, t);
+    } catch (...) {
+      errors[t] = std::current_exception();
+    }
+  };
+  {
+    // Joins the workers however this block is left, as a joinable thread can't be destroyed
+    struct JoinAll {
+      std::vector<std::thread> workers;
+      ~JoinAll() {
+        for (auto& worker : workers) {
+          worker.join();
+        }
+      }
+    } pool;
+    pool.workers.reserve(threads - 1);
+    for (std::size_t t = 0; t + 1 < threads; ++t) {
+      pool.workers.emplace_back(run, n * t / threads, n * (t + 1) / threads, t);
+    }
+    run(n * (threads - 1) / threads, n, threads - 1);
+  }
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_PARALLEL_H_
@@ -0,0 +1,80 @@
+#ifndef ASSIGNMENTS_DG_POOL_ALLOCATOR_H_
+#define ASSIGNMENTS_DG_POOL_ALLOCATOR_H_
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "assignments/dg/instrument.h"
+
+namespace gdwg {
+
+// Allocator that draws from a memory resource owned by a Graph. Unlike
+// std::pmr::polymorphic_allocator it travels with the container on move assignment and
+// swap, so a Graph can hand its containers and its pool to another Graph in O(1).
+template <typename T>
+class PoolAllocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::false_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  explicit PoolAllocator(std::pmr::memory_resource* resource) noexcept : resource_{resource} {}
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U>& other) noexcept : resource_{other.resource()} {}
+
+  T* allocate(std::size_t n) {
+    detail::CountAllocation();
+    return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T* p, std::size_t n) noexcept {
+    resource_->deallocate(p, n * sizeof(T), alignof(T));
+  }
+
+  std::pmr::memory_resource* resource() const noexcept { return resource_; }
+
+  friend bool operator==(const PoolAllocator& lhs, const PoolAllocator& rhs) noexcept {
+    return lhs.resource_ == rhs.resource_;
+  }
+  friend bool operator!=(const PoolAllocator& lhs, const PoolAllocator& rhs) noexcept {
+    return !(lhs == rhs);
+  }
+
+ private:
+  std::pmr::memory_resource* resource_;
+};
+
+// Deleter for objects made by MakePooled
+template <typename T>
+struct PoolDeleter {
+  std::pmr::memory_resource* resource = nullptr;
+
+  void operator()(T* p) const noexcept {
+    p->~T();
+    resource->deallocate(p, sizeof(T), alignof(T));
+  }
+};
+
+template <typename T>
+using pool_ptr = std::unique_ptr<T, PoolDeleter<T>>;
+
+// Constructs a T in memory taken from resource
+template <typename T, typename... Args>
+pool_ptr<T> MakePooled(std::pmr::memory_resource* resource, Args&&... args) {
+  detail::CountAllocation();
+  void* p = resource->allocate(sizeof(T), alignof(T));
+  try {
+    return pool_ptr<T>{new (p) T(std::forward<Args>(args)...), PoolDeleter<T>{resource}};
+  } catch (...) {
+    resource->deallocate(p, sizeof(T), alignof(T));
+    throw;
+  }
+}
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_POOL_ALLOCATOR_H_
@@ -0,0 +1,90 @@
+#ifndef ASSIGNMENTS_DG_SHORTEST_PATHS_H_
+#define ASSIGNMENTS_DG_SHORTEST_PATHS_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+
+namespace gdwg {
+
+// Result of a single-source shortest path search
+template <typename N, typename E>
+struct ShortestPaths {
+  // Distance from the source to every node reached, including the source itself
+  std::map<N, E> distance;
+  // Previous node on a shortest path, for every node reached except the source
+  std::map<N, N> predecessor;
+};
+
+// Dijkstra's algorithm over the graph's own adjacency. Weights must not be negative.
+// Integral weights are queued in a radix heap, any other weight type in a binary heap.
+// The first overload numbers every node before the search, so it is O(V) before any edge is
+// followed. The second numbers nodes as it reaches them and stops as soon as dst is settled,
+// so it only costs as much as the part of the graph at most as far away as dst, and only
+// those nodes are reported.
+// Throws std::out_of_range if src or dst is not in the graph and std::domain_error if a
+// negative weight is reached.
+template <typename N, typename E>
+ShortestPaths<N, E> Dijkstra(const Graph<N, E>& g, const N& src);
+template <typename N, typename E>
+ShortestPaths<N, E> Dijkstra(const Graph<N, E>& g, const N& src, const N& dst);
+
+// Bellman-Ford, for graphs with negative weights.
+// Throws std::out_of_range if src is not in the graph and std::domain_error if a negative
+// cycle can be reached from src.
+template <typename N, typename E>
+ShortestPaths<N, E> BellmanFord(const Graph<N, E>& g, const N& src);
+
+// Nodes on the shortest path to dst, starting with the source. Empty if dst wasn't reached.
+template <typename N, typename E>
+std::vector<N> PathTo(const ShortestPaths<N, E>& paths, const N& dst);
+
+namespace detail {
+
+// Min-heap of (distance, node id) pairs. Stale entries are left in and skipped by the caller.
+template <typename E>
+class BinaryHeap {
+ public:
+  void Push(const E& key, std::size_t id) { heap_.emplace(key, id); }
+  std::pair<E, std::size_t> Pop();
+  bool Empty() const { return heap_.empty(); }
+
+ private:
+  std::priority_queue<std::pair<E, std::size_t>,
+                      std::vector<std::pair<E, std::size_t>>,
+                      std::greater<std::pair<E, std::size_t>>>
+      heap_;
+};
+
+// Monotone radix heap for non-negative integral keys. Keys pushed must be no smaller than
+// the last key popped, which Dijkstra guarantees. Bucket i holds keys whose highest bit that
+// differs from the last key popped is bit i - 1.
+template <typename E>
+class RadixHeap {
+ public:
+  void Push(const E& key, std::size_t id);
+  std::pair<E, std::size_t> Pop();
+  bool Empty() const { return size_ == 0; }
+
+ private:
+  std::array<std::vector<std::pair<std::uint64_t, std::size_t>>, 65> buckets_;
+  std::uint64_t last_ = 0;
+  std::size_t size_ = 0;
+
+  std::size_t Bucket(std::uint64_t key) const;
+};
+
+}  // namespace detail
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_SHORTEST_PATHS_H_
+
+#include "assignments/dg/shortest_paths.tpp"
@@ -0,0 +1,288 @@
+#ifndef ASSIGNMENTS_DG_SHORTEST_PATHS_TPP_
+#define ASSIGNMENTS_DG_SHORTEST_PATHS_TPP_
+
+#include "assignments/dg/shortest_paths.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+namespace gdwg {
+namespace detail {
+
+template <typename E>
+std::pair<E, std::size_t> BinaryHeap<E>::Pop() {
+  auto top = heap_.top();
+  heap_.pop();
+  return top;
+}
+
+template <typename E>
+std::size_t RadixHeap<E>::Bucket(std::uint64_t key) const {
+  return key == last_ ? 0 : 64 - static_cast<std::size_t>(__builtin_clzll(key ^ last_));
+}
+
+template <typename E>
+void RadixHeap<E>::Push(const E& key, std::size_t id) {
+  auto unsigned_key = static_cast<std::uint64_t>(key);
+  buckets_[Bucket(unsigned_key)].emplace_back(unsigned_key, id);
+  ++size_;
+}
+
+template <typename E>
+std::pair<E, std::size_t> RadixHeap<E>::Pop() {
+  if (buckets_[0].empty()) {
+    // Move up to the smallest key in the first non-empty bucket and spread that bucket out.
+    // Every key in it now differs from last_ in a lower bit, so each lands in a lower bucket.
+    std::size_t i = 1;
+    while (buckets_[i].empty()) {
+      ++i;
+    }
+    last_ = std::min_element(buckets_[i].begin(), buckets_[i].end())->first;
+    for (const auto& item : buckets_[i]) {
+      buckets_[Bucket(item.first)].push_back(item);
+    }
+    buckets_[i].clear();
+  }
+  auto item = buckets_[0].back();
+  buckets_[0].pop_back();
+  --size_;
+  return {static_cast<E>(item.first), item.second};
+}
+
+// Dijkstra to every node reachable from src, with the given heap. The graph is indexed first,
+// so settling a node reads its edges and their targets' ids without searching or hashing.
+template <typename N, typename E, typename Heap>
+ShortestPaths<N, E> DijkstraAll(const Graph<N, E>& g, const N& src) {
+  const auto& adjacency = g.Adjacency();
+  auto start = adjacency.find(src);
+  if (start == adjacency.end()) {
+    throw std::out_of_range("Cannot call gdwg::Dijkstra if src doesn't exist in the graph");
+  }
+
+  constexpr auto none = std::numeric_limits<std::size_t>::max();
+  const detail::NodeIndex<typename Graph<N, E>::node_map> index{adjacency};
+  const auto& nodes = index.nodes;
+  std::vector<E> distance(nodes.size());
+  std::vector<std::size_t> predecessor(nodes.size(), none);
+  std::vector<bool> reached(nodes.size(), false);
+  std::vector<bool> settled(nodes.size(), false);
+
+  // Ids are map positions
+  auto first = static_cast<std::size_t>(std::distance(adjacency.begin(), start));
+  reached[first] = true;
+  Heap heap;
+  heap.Push(E{}, first);
+  while (!heap.Empty()) {
+    auto [d, u] = heap.Pop();
+    if (settled[u] || distance[u] < d) {
+      continue;
+    }
+    settled[u] = true;
+
+    // The index lists targets in the order of the edge set, so weights are read alongside
+    auto out = nodes[u]->second.begin();
+    for (auto e = index.offsets[u]; e < index.offsets[u + 1]; ++e, ++out) {
+      const E& w = std::get<1>(**out);
+      if (w < E{}) {
+        throw std::domain_error("Cannot call gdwg::Dijkstra on a graph with negative weights");
+      }
+      E candidate = distance[u] + w;
+      std::size_t v = index.targets[e];
+      if (!reached[v] || (!settled[v] && candidate < distance[v])) {
+        reached[v] = true;
+        distance[v] = candidate;
+        predecessor[v] = u;
+        heap.Push(candidate, v);
+      }
+    }
+  }
+
+  // Only settled nodes have final distances. Ids are in sorted order, so the results are
+  // appended at the end of each map.
+  ShortestPaths<N, E> paths;
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    if (settled[i]) {
+      paths.distance.emplace_hint(paths.distance.end(), *nodes[i]->first, distance[i]);
+      if (predecessor[i] != none) {
+        paths.predecessor.emplace_hint(paths.predecessor.end(), *nodes[i]->first,
+                                       *nodes[predecessor[i]]->first);
+      }
+    }
+  }
+  return paths;
+}
+
+// Dijkstra from src that stops once target is settled, with the given heap. Nodes get ids as
+// they are reached and their edges are looked up in the map as they are settled, so the search
+// costs nothing for the part of the graph further away than target.
+template <typename N, typename E, typename Heap>
+ShortestPaths<N, E> DijkstraTo(const Graph<N, E>& g, const N& src, const N* target) {
+  const auto& adjacency = g.Adjacency();
+  auto start = adjacency.find(src);
+  if (start == adjacency.end()) {
+    throw std::out_of_range("Cannot call gdwg::Dijkstra if src doesn't exist in the graph");
+  }
+
+  constexpr auto none = std::numeric_limits<std::size_t>::max();
+  std::unordered_map<const N*, std::size_t> ids;
+  std::vector<const N*> nodes;
+  std::vector<E> distance;
+  std::vector<std::size_t> predecessor;
+  std::vector<bool> settled;
+  // Ids in the order they were settled
+  std::vector<std::size_t> order;
+
+  ids.emplace(start->first.get(), 0);
+  nodes.push_back(start->first.get());
+  distance.push_back(E{});
+  predecessor.push_back(none);
+  settled.push_back(false);
+
+  Heap heap;
+  heap.Push(E{}, 0);
+  while (!heap.Empty()) {
+    auto [d, u] = heap.Pop();
+    if (settled[u] || distance[u] < d) {
+      continue;
+    }
+    settled[u] = true;
+    order.push_back(u);
+    if (nodes[u] == target) {
+      break;
+    }
+
+    for (const auto& out : adjacency.find(*nodes[u])->second) {
+      const N& dst = std::get<0>(*out);
+      const E& w = std::get<1>(*out);
+      if (w < E{}) {
+        throw std::domain_error("Cannot call gdwg::Dijkstra on a graph with negative weights");
+      }
+      E candidate = distance[u] + w;
+      auto search = ids.emplace(&dst, nodes.size());
+      std::size_t v = search.first->second;
+      if (search.second) {
+        nodes.push_back(&dst);
+        distance.push_back(candidate);
+        predecessor.push_back(u);
+        settled.push_back(false);
+        heap.Push(candidate, v);
+      } else if (!settled[v] && candidate < distance[v]) {
+        distance[v] = candidate;
+        predecessor[v] = u;
+        heap.Push(candidate, v);
+      }
+    }
+  }
+
+  // Only settled nodes have final distances
+  ShortestPaths<N, E> paths;
+  for (auto u : order) {
+    paths.distance.emplace(*nodes[u], distance[u]);
+    if (predecessor[u] != none) {
+      paths.predecessor.emplace(*nodes[u], *nodes[predecessor[u]]);
+    }
+  }
+  return paths;
+}
+
+template <typename E>
+using DijkstraHeap = std::conditional_t<std::is_integral<E>::value, RadixHeap<E>, BinaryHeap<E>>;
+
+}  // namespace detail
+}  // namespace gdwg
+
+template <typename N, typename E>
+gdwg::ShortestPaths<N, E> gdwg::Dijkstra(const Graph<N, E>& g, const N& src) {
+  return detail::DijkstraAll<N, E, detail::DijkstraHeap<E>>(g, src);
+}
+
+template <typename N, typename E>
+gdwg::ShortestPaths<N, E> gdwg::Dijkstra(const Graph<N, E>& g, const N& src, const N& dst) {
+  auto target = g.Adjacency().find(dst);
+  if (target == g.Adjacency().end()) {
+    throw std::out_of_range("Cannot call gdwg::Dijkstra if dst doesn't exist in the graph");
+  }
+  return detail::DijkstraTo<N, E, detail::DijkstraHeap<E>>(g, src, target->first.get());
+}
+
+template <typename N, typename E>
+gdwg::ShortestPaths<N, E> gdwg::BellmanFord(const Graph<N, E>& g, const N& src) {
+  const auto& adjacency = g.Adjacency();
+  auto start = adjacency.find(src);
+  if (start == adjacency.end()) {
+    throw std::out_of_range("Cannot call gdwg::BellmanFord if src doesn't exist in the graph");
+  }
+
+  // Number the nodes in map order and flatten the edges into (src id, dst id, weight) triples,
+  // so the relaxation passes don't repeat any lookups
+  const detail::NodeIndex<typename Graph<N, E>::node_map> index{adjacency};
+  const auto& nodes = index.nodes;
+  std::vector<std::tuple<std::size_t, std::size_t, const E*>> edges;
+  edges.reserve(index.targets.size());
+  for (std::size_t u = 0; u < nodes.size(); ++u) {
+    auto out = nodes[u]->second.begin();
+    for (auto e = index.offsets[u]; e < index.offsets[u + 1]; ++e, ++out) {
+      edges.emplace_back(u, index.targets[e], &std::get<1>(**out));
+    }
+  }
+
+  constexpr auto none = std::numeric_limits<std::size_t>::max();
+  std::vector<E> distance(nodes.size());
+  std::vector<std::size_t> predecessor(nodes.size(), none);
+  std::vector<bool> reached(nodes.size(), false);
+  reached[static_cast<std::size_t>(std::distance(adjacency.begin(), start))] = true;
+
+  // After |V| - 1 passes every distance is final, so a change in pass |V| means a negative cycle
+  for (std::size_t pass = 1;; ++pass) {
+    bool changed = false;
+    for (const auto& [from, to, w] : edges) {
+      if (reached[from] && (!reached[to] || distance[from] + *w < distance[to])) {
+        distance[to] = distance[from] + *w;
+        predecessor[to] = from;
+        reached[to] = true;
+        changed = true;
+      }
+    }
+    if (!changed) {
+      break;
+    }
+    if (pass == nodes.size()) {
+      throw std::domain_error(
+          "Cannot call gdwg::BellmanFord if a negative cycle can be reached from src");
+    }
+  }
+
+  // Ids are in sorted order, so the results are appended at the end of each map
+  ShortestPaths<N, E> paths;
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    if (reached[i]) {
+      paths.distance.emplace_hint(paths.distance.end(), *nodes[i]->first, distance[i]);
+      if (predecessor[i] != none) {
+        paths.predecessor.emplace_hint(paths.predecessor.end(), *nodes[i]->first,
+                                       *nodes[predecessor[i]]->first);
+      }
+    }
+  }
+  return paths;
+}
+
+template <typename N, typename E>
+std::vector<N> gdwg::PathTo(const ShortestPaths<N, E>& paths, const N& dst) {
+  std::vector<N> path;
+  if (paths.distance.find(dst) == paths.distance.end()) {
+    return path;
+  }
+  path.push_back(dst);
+  for (auto it = paths.predecessor.find(dst); it != paths.predecessor.end();
+       it = paths.predecessor.find(it->second)) {
+    path.push_back(it->second);
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+#endif
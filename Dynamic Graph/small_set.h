@@ -0,0 +1,145 @@
+#ifndef ASSIGNMENTS_DG_SMALL_SET_H_
+#define ASSIGNMENTS_DG_SMALL_SET_H_
+
+#include <cstddef>
+#include <iterator>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/pool_allocator.h"
+
+namespace gdwg {
+
+// Sorted set that keeps up to kFlat elements in a flat array and moves them to a std::set once
+// it grows past that. Small sets cost one array slot per element instead of a tree node, and
+// searching them is a binary search over contiguous memory.
+// The interface is the part of std::set Graph uses, including transparent lookups. Unlike
+// std::set, inserting or erasing invalidates iterators at or after the position changed, and
+// moving to the tree invalidates them all. Iterators returned by insert and erase stay valid.
+// Alloc is a PoolAllocator, which also provides the tree once the set is large.
+template <typename T, typename Compare, typename Alloc, std::size_t kFlat>
+class SmallSet {
+  using flat_type = std::vector<T, Alloc>;
+  using tree_type = std::set<T, Compare, Alloc>;
+
+ public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using allocator_type = Alloc;
+
+  class const_iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using reference = const T&;
+    using pointer = const T*;
+    using difference_type = std::ptrdiff_t;
+
+    const_iterator() = default;
+
+    reference operator*() const { return tree_ ? *node_ : *flat_; }
+    pointer operator->() const { return &**this; }
+    const_iterator& operator++() {
+      if (tree_) {
+        ++node_;
+      } else {
+        ++flat_;
+      }
+      return *this;
+    }
+    const_iterator operator++(int) {
+      auto copy{*this};
+      ++(*this);
+      return copy;
+    }
+    const_iterator& operator--() {
+      if (tree_) {
+        --node_;
+      } else {
+        --flat_;
+      }
+      return *this;
+    }
+    const_iterator operator--(int) {
+      auto copy{*this};
+      --(*this);
+      return copy;
+    }
+    friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) {
+      return lhs.tree_ ? lhs.node_ == rhs.node_ : lhs.flat_ == rhs.flat_;
+    }
+    friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+   private:
+    const T* flat_ = nullptr;
+    typename tree_type::const_iterator node_{};
+    bool tree_ = false;
+
+    friend class SmallSet;
+
+    explicit const_iterator(const T* flat) : flat_{flat} {}
+    explicit const_iterator(typename tree_type::const_iterator node) : node_{node}, tree_{true} {}
+  };
+  using iterator = const_iterator;
+
+  // Constructors
+  explicit SmallSet(const Alloc& alloc) : flat_{alloc} {}
+  SmallSet(SmallSet&&) noexcept = default;
+  SmallSet(const SmallSet&) = delete;
+
+  // Operations
+  SmallSet& operator=(SmallSet&&) noexcept = default;
+  SmallSet& operator=(const SmallSet&) = delete;
+
+  // Iterator methods
+  const_iterator begin() const;
+  const_iterator end() const;
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  // Methods
+  size_type size() const { return tree_ ? tree_->size() : flat_.size(); }
+  bool empty() const { return size() == 0; }
+  // Makes room for n elements, going straight to the tree if they won't fit in the array
+  void reserve(size_type n);
+  template <typename K>
+  const_iterator find(const K& key) const;
+  template <typename K>
+  const_iterator lower_bound(const K& key) const;
+  template <typename K>
+  const_iterator upper_bound(const K& key) const;
+  template <typename K>
+  std::pair<const_iterator, const_iterator> equal_range(const K& key) const;
+  template <typename... Args>
+  std::pair<const_iterator, bool> emplace(Args&&... args);
+  // The hint is where the element goes if it is right, as for std::set
+  template <typename... Args>
+  const_iterator emplace_hint(const_iterator hint, Args&&... args);
+  std::pair<const_iterator, bool> insert(T&& value) { return emplace(std::move(value)); }
+  const_iterator erase(const_iterator position);
+  const_iterator erase(const_iterator first, const_iterator last);
+  // Removes the element at position and returns it
+  T extract(const_iterator position);
+
+ private:
+  flat_type flat_;
+  // Set once the elements outgrow the array, which is then left empty
+  pool_ptr<tree_type> tree_;
+
+  Alloc get_allocator() const { return flat_.get_allocator(); }
+  const_iterator Flat(std::size_t i) const { return const_iterator{flat_.data() + i}; }
+  std::size_t Index(const_iterator it) const {
+    return static_cast<std::size_t>(it.flat_ - flat_.data());
+  }
+  // Puts value at position i of the array, or moves everything to the tree if it is full
+  const_iterator Place(std::size_t i, T&& value);
+};
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_SMALL_SET_H_
+
+#include "assignments/dg/small_set.tpp"
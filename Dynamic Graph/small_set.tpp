@@ -0,0 +1,164 @@
+#ifndef ASSIGNMENTS_DG_SMALL_SET_TPP_
+#define ASSIGNMENTS_DG_SMALL_SET_TPP_
+
+#include "assignments/dg/small_set.h"
+
+#include <algorithm>
+
+template <typename T, typename Compare, typename Alloc, std::size_t kFlat>
+typename gdwg::SmallSet<T, Compare, Alloc, kFlat>::const_iterator
+gdwg::SmallSet<T, Compare, Alloc, kFlat>::begin() const {
+  return tree_ ? const_iterator{tree_->cbegin()} : Flat(0);
+}
+
+template <typename T, typename Compare, typename Alloc, std::size_t kFlat>
+typename gdwg::SmallSet<T, Compare, Alloc, kFlat>::const_iterator
+gdwg::SmallSet<T, Compare, Alloc, kFlat>::end() const {
+  return tree_ ? const_iterator{tree_->cend()} : Flat(flat_.size());
+}
+
+template <typename T, typename Compare, typename Alloc, std::size_t kFlat>
+void gdwg::SmallSet<T, Compare, Alloc, kFlat>::reserve(size_type n) {
+  if (tree_) {
+    return;
+  }
+  if (n <= kFlat) {
+    flat_.reserve(n);
+    return;
+  }
+  tree_ = MakePooled<tree_type>(get_allocator().resource(), Compare{}, get_allocator());
+  for (auto& value : flat_) {
+    tree_->emplace_hint(tree_->end(), std::move(value));
+  }
+  flat_type{get_allocator()}.swap(flat_);
+}
+
+template <typename T, typename Compare, typename Alloc, std::size_t kFlat>
+template <typename K>
+typename gdwg::SmallSet<T, Compare, Alloc, kFlat>::const_iterator
+gdwg::SmallSet<T, Compare, Alloc, kFlat>::find(const K& key) const {
+  auto search = lower_bound(key);
+  if (search == end() || Compare{}(key, *search)) {
+    return end();
+  }
+  return search;
+}
+
+template <typename T, typename Compare, typename Alloc, std::size_t kFlat>
+template <typename K>
+typename gdwg::SmallSet<T, Compare, Alloc, kFlat>::const_iterator
+gdwg::SmallSet<T, Compare, Alloc, kFlat>::lower_bound(const K& key) const {
+  if (tree_) {
+    return const_iterator{tree_->lower_bound(key)};
+  }
+  return const_iterator{std::lower_bound(flat_.data(), flat_.data() + flat_.size(), key,
+                                         Compare{})};
+}
+
+template <typename T, typename Compare, typename Alloc, std::size_t kFlat>
+template <typename K>
+typename gdwg::SmallSet<T, Compare, Alloc, kFlat>::const_iterator
+gdwg::SmallSet<T, Compare, Alloc, kFlat>::upper_bound(const K& key) const {
+  if (tree_) {
+    return const_iterator{tree_->upper_bound(key)};
+  }
+  return const_iterator{std::upper_bound(flat_.data(), flat_.data() + flat_.size(), key,
+                                         Compare{})};
+}
+
+template <typename T, typename Compare, typename Alloc, std::size_t kFlat>
+template <typename K>
+std::pair<typename gdwg::SmallSet<T, Compare, Alloc, kFlat>::const_iterator,
+          typename gdwg::SmallSet<T, Compare, Alloc, kFlat>::const_iterator>
+gdwg::SmallSet<T, Compare, Alloc, kFlat>::equal_range(const K& key) const {
+  if (tree_) {
+    auto range = tree_->equal_range(key);
+    return {const_iterator{range.first}, const_iterator{range.second}};
+  }
+  auto range = std::equal_range(flat_.data(), flat_.data() + flat_.size(), key, Compare{});
+  return {const_iterator{range.first}, const_iterator{range.second}};
+}
+
+template <typename T, typename Compare, typename Alloc, std::size_t kFlat>
+template <typename... Args>
+std::pair<typename gdwg::SmallSet<T, Compare, Alloc, kFlat>::const_iterator, bool>
+gdwg::SmallSet<T, Compare, Alloc, kFlat>::emplace(Args&&... args) {
+  T value(std::forward<Args>(args)...);
+  if (tree_) {
+    auto inserted = tree_->insert(std::move(value));
+    return {const_iterator{inserted.first}, inserted.second};
+  }
+  auto search = lower_bound(value);
+  if (search != end() && !Compare{}(value, *search)) {
+    return {search, false};
+  }
+  return {Place(Index(search), std::move(value)), true};
+}
+
+template <typename T, typename Compare, typename Alloc, std::size_t kFlat>
+template <typename... Args>
+typename gdwg::SmallSet<T, Compare, Alloc, kFlat>::const_iterator
+gdwg::SmallSet<T, Compare, Alloc, kFlat>::emplace_hint(const_iterator hint, Args&&... args) {
+  if (tree_) {
+    return const_iterator{tree_->emplace_hint(hint.node_, std::forward<Args>(args)...)};
+  }
+  T value(std::forward<Args>(args)...);
+  auto i = Index(hint);
+  // Fall back to a search if the value doesn't belong right before the hint
+  if ((i > 0 && !Compare{}(flat_[i - 1], value)) ||
+      (i < flat_.size() && !Compare{}(value, flat_[i]))) {
+    auto search = lower_bound(value);
+    if (search != end() && !Compare{}(value, *search)) {
+      return search;
+    }
+    i = Index(search);
+  }
+  return Place(i, std::move(value));
+}
+
+template <typename T, typename Compare, typename Alloc, std::size_t kFlat>
+typename gdwg::SmallSet<T, Compare, Alloc, kFlat>::const_iterator
+gdwg::SmallSet<T, Compare, Alloc, kFlat>::erase(const_iterator position) {
+  if (tree_) {
+    return const_iterator{tree_->erase(position.node_)};
+  }
+  auto i = Index(position);
+  flat_.erase(flat_.begin() + static_cast<std::ptrdiff_t>(i));
+  return Flat(i);
+}
+
+template <typename T, typename Compare, typename Alloc, std::size_t kFlat>
+typename gdwg::SmallSet<T, Compare, Alloc, kFlat>::const_iterator
+gdwg::SmallSet<T, Compare, Alloc, kFlat>::erase(const_iterator first, const_iterator last) {
+  if (tree_) {
+    return const_iterator{tree_->erase(first.node_, last.node_)};
+  }
+  auto i = Index(first);
+  flat_.erase(flat_.begin() + static_cast<std::ptrdiff_t>(i),
+              flat_.begin() + static_cast<std::ptrdiff_t>(Index(last)));
+  return Flat(i);
+}
+
+template <typename T, typename Compare, typename Alloc, std::size_t kFlat>
+T gdwg::SmallSet<T, Compare, Alloc, kFlat>::extract(const_iterator position) {
+  if (tree_) {
+    return std::move(tree_->extract(position.node_).value());
+  }
+  auto it = flat_.begin() + static_cast<std::ptrdiff_t>(Index(position));
+  T value = std::move(*it);
+  flat_.erase(it);
+  return value;
+}
+
+template <typename T, typename Compare, typename Alloc, std::size_t kFlat>
+typename gdwg::SmallSet<T, Compare, Alloc, kFlat>::const_iterator
+gdwg::SmallSet<T, Compare, Alloc, kFlat>::Place(std::size_t i, T&& value) {
+  if (flat_.size() < kFlat) {
+    flat_.insert(flat_.begin() + static_cast<std::ptrdiff_t>(i), std::move(value));
+    return Flat(i);
+  }
+  reserve(kFlat + 1);
+  return const_iterator{tree_->insert(std::move(value)).first};
+}
+
+#endif
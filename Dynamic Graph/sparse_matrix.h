@@ -0,0 +1,57 @@
+#ifndef ASSIGNMENTS_DG_SPARSE_MATRIX_H_
+#define ASSIGNMENTS_DG_SPARSE_MATRIX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "assignments/dg/csr_graph.h"
+
+namespace gdwg {
+
+struct SpmvOptions {
+  // 0 uses one thread per hardware thread
+  std::size_t threads = 0;
+  // Multiply computes y = damping * (M x) + teleport * bias, where a null bias is all ones
+  double damping = 1;
+  double teleport = 0;
+  const double* bias = nullptr;
+};
+
+// Square sparse matrix of doubles in compressed sparse row form, built from a graph's edge
+// weights, with a multithreaded matrix-vector product.
+class SparseMatrix {
+ public:
+  // Constructors
+  SparseMatrix() : offsets_{0} {}
+  SparseMatrix(std::vector<std::size_t> offsets,
+               std::vector<std::uint32_t> columns,
+               std::vector<double> values);
+
+  // Row v holds w(u, v) / (total weight out of u) at column u for every edge u -> v, so the
+  // columns of nodes with edges out sum to 1 and M x pushes each node's x along its edges in
+  // proportion to their weight. Column u is empty if u has no edges out (a dangling node).
+  // Throws std::domain_error if a weight is negative.
+  template <typename N, typename E>
+  static SparseMatrix Transition(const CsrGraph<N, E>& g);
+
+  // Methods
+  std::size_t Rows() const { return offsets_.size() - 1; }
+  std::size_t NonZeros() const { return columns_.size(); }
+  // Bytes of the matrix itself, all of which Multiply reads once
+  std::size_t Bytes() const;
+  // Writes y = damping * (M x) + teleport * bias. x and y hold Rows() values and must not
+  // overlap. Rows are split between threads so each gets about as many non-zeros.
+  void Multiply(const double* x, double* y, const SpmvOptions& options = {}) const;
+
+ private:
+  std::vector<std::size_t> offsets_;
+  std::vector<std::uint32_t> columns_;
+  std::vector<double> values_;
+};
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_SPARSE_MATRIX_H_
+
+#include "assignments/dg/sparse_matrix.tpp"
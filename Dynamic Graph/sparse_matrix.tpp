@@ -0,0 +1,101 @@
+#ifndef ASSIGNMENTS_DG_SPARSE_MATRIX_TPP_
+#define ASSIGNMENTS_DG_SPARSE_MATRIX_TPP_
+
+#include "assignments/dg/sparse_matrix.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "assignments/dg/parallel.h"
+
+// Begin constructors
+inline gdwg::SparseMatrix::SparseMatrix(std::vector<std::size_t> offsets,
+                                        std::vector<std::uint32_t> columns,
+                                        std::vector<double> values)
+  : offsets_{std::move(offsets)}, columns_{std::move(columns)}, values_{std::move(values)} {}
+// end constructors
+
+template <typename N, typename E>
+gdwg::SparseMatrix gdwg::SparseMatrix::Transition(const CsrGraph<N, E>& g) {
+  const std::size_t n = g.NodeCount();
+  const auto& offsets = g.Offsets();
+  const auto& targets = g.Targets();
+  const auto& weights = g.Weights();
+
+  // Rows are the graph's in-edges, which its reverse index has already counted
+  std::vector<std::size_t> rows = g.InOffsets();
+  std::vector<std::uint32_t> columns(g.EdgeCount());
+  std::vector<double> values(g.EdgeCount());
+  std::vector<std::size_t> next(rows.begin(), rows.end() - 1);
+  for (std::size_t u = 0; u < n; ++u) {
+    double total = 0;
+    for (auto i = offsets[u]; i < offsets[u + 1]; ++i) {
+      auto weight = static_cast<double>(weights[i]);
+      if (weight < 0) {
+        throw std::domain_error(
+            "Cannot call gdwg::SparseMatrix::Transition on a graph with negative weights");
+      }
+      total += weight;
+    }
+    // An edge set whose weights are all 0 shares the node's x evenly instead
+    auto degree = static_cast<double>(offsets[u + 1] - offsets[u]);
+    for (auto i = offsets[u]; i < offsets[u + 1]; ++i) {
+      auto slot = next[targets[i]]++;
+      columns[slot] = static_cast<std::uint32_t>(u);
+      values[slot] = total > 0 ? static_cast<double>(weights[i]) / total : 1 / degree;
+    }
+  }
+  return SparseMatrix{std::move(rows), std::move(columns), std::move(values)};
+}
+
+inline std::size_t gdwg::SparseMatrix::Bytes() const {
+  return offsets_.size() * sizeof(std::size_t) + columns_.size() * sizeof(std::uint32_t) +
+         values_.size() * sizeof(double);
+}
+
+inline void gdwg::SparseMatrix::Multiply(const double* x,
+                                         double* y,
+                                         const SpmvOptions& options) const {
+  const std::size_t rows = Rows();
+  std::size_t threads = options.threads == 0 ? DefaultThreads() : options.threads;
+  threads = std::max<std::size_t>(1, std::min(threads, rows));
+
+  // Cut the rows where the running count of non-zeros crosses each thread's share
+  std::vector<std::size_t> cuts(threads + 1, rows);
+  cuts[0] = 0;
+  for (std::size_t t = 1; t < threads; ++t) {
+    auto share = NonZeros() / threads * t;
+    cuts[t] = static_cast<std::size_t>(
+        std::lower_bound(offsets_.begin() + static_cast<std::ptrdiff_t>(cuts[t - 1]),
+                         offsets_.end() - 1, share) -
+        offsets_.begin());
+  }
+
+  const std::size_t* offsets = offsets_.data();
+  const std::uint32_t* columns = columns_.data();
+  const double* values = values_.data();
+  ParallelFor(threads, threads, [&](std::size_t, std::size_t, std::size_t t) {
+    for (auto row = cuts[t]; row < cuts[t + 1]; ++row) {
+      // Four independent sums, so the additions don't wait on each other and the compiler can
+      // keep them in vector registers
+      double sums[4] = {0, 0, 0, 0};
+      auto i = offsets[row];
+      const auto end = offsets[row + 1];
+      for (; i + 4 <= end; i += 4) {
+        sums[0] += values[i] * x[columns[i]];
+        sums[1] += values[i + 1] * x[columns[i + 1]];
+        sums[2] += values[i + 2] * x[columns[i + 2]];
+        sums[3] += values[i + 3] * x[columns[i + 3]];
+      }
+      for (; i < end; ++i) {
+        sums[0] += values[i] * x[columns[i]];
+      }
+      auto bias = options.bias == nullptr ? 1 : options.bias[row];
+      y[row] = options.damping * ((sums[0] + sums[1]) + (sums[2] + sums[3])) +
+               options.teleport * bias;
+    }
+  });
+}
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef ASSIGNMENTS_DG_TOPOLOGICAL_SORT_H_
+#define ASSIGNMENTS_DG_TOPOLOGICAL_SORT_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+
+namespace gdwg {
+
+struct TopologicalOptions {
+  // Threads sharing each level of Kahn's algorithm. 0 uses one per hardware thread. Levels
+  // too small to be worth splitting run on the calling thread.
+  std::size_t threads = 1;
+};
+
+// Heaviest path through a DAG
+template <typename N, typename E>
+struct CriticalPath {
+  // Sum of the weights along the path
+  E length{};
+  // Nodes on the path in order. Empty only for an empty graph.
+  std::vector<N> nodes;
+};
+
+// Nodes ordered so every edge goes from an earlier node to a later one, by Kahn's algorithm.
+// Nodes are taken a level at a time: first those with no edges in, then those whose edges in
+// all come from earlier levels, and so on. Each level is in sorted order, so the result is the
+// same however many threads are used.
+// Throws std::domain_error if the graph has a cycle. FindCycle names one.
+template <typename N, typename E>
+std::vector<N> TopologicalSort(const Graph<N, E>& g, const TopologicalOptions& options = {});
+
+// A cycle as the nodes along it: each has an edge to the next and the last has one to the
+// first. A self loop is a cycle of one node. Empty if the graph is acyclic.
+// Depth-first search from each node in sorted order, with an explicit stack.
+template <typename N, typename E>
+std::vector<N> FindCycle(const Graph<N, E>& g);
+
+// The path whose weights sum highest, for critical paths through a job graph. Paths may start
+// at any node, and a single node is a path of length E{}. Ties go to the path ending at the
+// earliest node in topological order.
+// Throws std::domain_error if the graph has a cycle.
+template <typename N, typename E>
+CriticalPath<N, E> LongestPath(const Graph<N, E>& g);
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_TOPOLOGICAL_SORT_H_
+
+#include "assignments/dg/topological_sort.tpp"
@@ -0,0 +1,193 @@
+#ifndef ASSIGNMENTS_DG_TOPOLOGICAL_SORT_TPP_
+#define ASSIGNMENTS_DG_TOPOLOGICAL_SORT_TPP_
+
+#include "assignments/dg/topological_sort.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "assignments/dg/node_index.h"
+#include "assignments/dg/parallel.h"
+
+namespace gdwg {
+namespace detail {
+
+template <typename N, typename E>
+using GraphIndex = NodeIndex<typename Graph<N, E>::node_map>;
+
+// A level with fewer nodes than this per thread is cheaper to run alone than to split
+constexpr std::size_t kMinLevelPerThread = 4096;
+
+// Kahn's algorithm a level at a time, each level sorted. Nodes on or behind a cycle never
+// reach in-degree 0, so the order is short of the node count exactly when there is a cycle.
+template <typename Map>
+std::vector<std::uint32_t> KahnOrder(const NodeIndex<Map>& index, std::size_t threads) {
+  const std::size_t n = index.nodes.size();
+  const auto& offsets = index.offsets;
+  const auto& targets = index.targets;
+
+  // Atomic so a split level can count down in-degrees from several threads. Alone, plain
+  // loads and stores do.
+  std::vector<std::atomic<std::uint32_t>> in(n);
+  for (auto v : targets) {
+    in[v].store(in[v].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+  std::vector<std::uint32_t> order;
+  order.reserve(n);
+  for (std::size_t v = 0; v < n; ++v) {
+    if (in[v].load(std::memory_order_relaxed) == 0) {
+      order.push_back(static_cast<std::uint32_t>(v));
+    }
+  }
+
+  // Nodes each thread freed, appended after the level in thread order
+  std::vector<std::vector<std::uint32_t>> freed(threads);
+  std::size_t level_begin = 0;
+  while (level_begin < order.size()) {
+    const std::size_t level_end = order.size();
+    const std::size_t level = level_end - level_begin;
+    const std::size_t parts = std::min(threads, level / kMinLevelPerThread);
+    if (parts > 1) {
+      ParallelFor(parts, level, [&](std::size_t begin, std::size_t end, std::size_t t) {
+        freed[t].clear();
+        for (auto i = level_begin + begin; i < level_begin + end; ++i) {
+          auto u = order[i];
+          for (auto edge = offsets[u]; edge < offsets[u + 1]; ++edge) {
+            auto v = targets[edge];
+            if (in[v].fetch_sub(1, std::memory_order_relaxed) == 1) {
+              freed[t].push_back(v);
+            }
+          }
+        }
+      });
+      for (std::size_t t = 0; t < parts; ++t) {
+        order.insert(order.end(), freed[t].begin(), freed[t].end());
+      }
+    } else {
+      for (auto i = level_begin; i < level_end; ++i) {
+        auto u = order[i];
+        for (auto edge = offsets[u]; edge < offsets[u + 1]; ++edge) {
+          auto v = targets[edge];
+          auto count = in[v].load(std::memory_order_relaxed) - 1;
+          in[v].store(count, std::memory_order_relaxed);
+          if (count == 0) {
+            order.push_back(v);
+          }
+        }
+      }
+    }
+    std::sort(order.begin() + static_cast<std::ptrdiff_t>(level_end), order.end());
+    level_begin = level_end;
+  }
+  return order;
+}
+
+}  // namespace detail
+}  // namespace gdwg
+
+template <typename N, typename E>
+std::vector<N> gdwg::TopologicalSort(const Graph<N, E>& g, const TopologicalOptions& options) {
+  detail::GraphIndex<N, E> index{g.Adjacency()};
+  const std::size_t threads = options.threads == 0 ? DefaultThreads() : options.threads;
+  auto order = detail::KahnOrder(index, std::max<std::size_t>(1, threads));
+  if (order.size() < index.nodes.size()) {
+    throw std::domain_error("Cannot call gdwg::TopologicalSort on a graph with a cycle");
+  }
+  std::vector<N> sorted;
+  sorted.reserve(order.size());
+  for (auto v : order) {
+    sorted.push_back(*index.nodes[v]->first);
+  }
+  return sorted;
+}
+
+template <typename N, typename E>
+std::vector<N> gdwg::FindCycle(const Graph<N, E>& g) {
+  enum class State : std::uint8_t { kNew, kOnPath, kDone };
+  detail::GraphIndex<N, E> index{g.Adjacency()};
+  const std::size_t n = index.nodes.size();
+  const auto& offsets = index.offsets;
+  const auto& targets = index.targets;
+
+  std::vector<State> state(n, State::kNew);
+  // The current path and the next edge to follow from each node on it
+  std::vector<std::pair<std::uint32_t, std::size_t>> calls;
+  for (std::uint32_t start = 0; start < n; ++start) {
+    if (state[start] != State::kNew) {
+      continue;
+    }
+    state[start] = State::kOnPath;
+    calls.emplace_back(start, offsets[start]);
+    while (!calls.empty()) {
+      auto& [v, edge] = calls.back();
+      if (edge == offsets[v + 1]) {
+        state[v] = State::kDone;
+        calls.pop_back();
+        continue;
+      }
+      auto w = targets[edge++];
+      if (state[w] == State::kNew) {
+        state[w] = State::kOnPath;
+        calls.emplace_back(w, offsets[w]);
+      } else if (state[w] == State::kOnPath) {
+        // An edge back onto the path closes the cycle running from w to the end of the path
+        std::vector<N> cycle;
+        auto first = std::find_if(calls.begin(), calls.end(),
+                                  [w](const auto& call) { return call.first == w; });
+        for (auto it = first; it != calls.end(); ++it) {
+          cycle.push_back(*index.nodes[it->first]->first);
+        }
+        return cycle;
+      }
+    }
+  }
+  return {};
+}
+
+template <typename N, typename E>
+gdwg::CriticalPath<N, E> gdwg::LongestPath(const Graph<N, E>& g) {
+  constexpr auto none = std::numeric_limits<std::uint32_t>::max();
+  detail::GraphIndex<N, E> index{g.Adjacency()};
+  const std::size_t n = index.nodes.size();
+  auto order = detail::KahnOrder(index, 1);
+  if (order.size() < n) {
+    throw std::domain_error("Cannot call gdwg::LongestPath on a graph with a cycle");
+  }
+
+  // Heaviest path ending at each node and the node before it on that path. Every edge into a
+  // node comes from earlier in the order, so each node is final by the time it is reached.
+  std::vector<E> length(n, E{});
+  std::vector<std::uint32_t> previous(n, none);
+  auto best = none;
+  for (auto u : order) {
+    auto edge = index.nodes[u]->second.begin();
+    for (auto i = index.offsets[u]; i < index.offsets[u + 1]; ++i, ++edge) {
+      auto v = index.targets[i];
+      E candidate = length[u] + std::get<1>(**edge);
+      if (length[v] < candidate) {
+        length[v] = candidate;
+        previous[v] = u;
+      }
+    }
+    if (best == none || length[best] < length[u]) {
+      best = u;
+    }
+  }
+
+  CriticalPath<N, E> path;
+  if (best == none) {
+    return path;
+  }
+  path.length = length[best];
+  for (auto v = best; v != none; v = previous[v]) {
+    path.nodes.push_back(*index.nodes[v]->first);
+  }
+  std::reverse(path.nodes.begin(), path.nodes.end());
+  return path;
+}
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef ASSIGNMENTS_DG_WATCHED_GRAPH_H_
+#define ASSIGNMENTS_DG_WATCHED_GRAPH_H_
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/shortest_paths.h"
+
+namespace gdwg {
+
+// A Graph that keeps a shortest path tree up to date for each of a set of watched sources, so
+// distances from them can be read at any time without searching. Weights must not be negative.
+// An insert that shortens a path runs Dijkstra from the edge's destination, and stops at nodes
+// it doesn't improve. An erase or DeleteNode that cuts a tree edge clears the subtree below
+// it, seeds each cleared node from its edges in that don't come from the subtree, and runs
+// Dijkstra over the subtree alone (Ramalingam and Reps). Either way an update costs about the
+// edges of the nodes whose distance changes, not the size of the graph.
+template <typename N, typename E>
+class WatchedGraph {
+ public:
+  // Constructors
+  WatchedGraph() = default;
+  // Throws std::domain_error if graph has a negative weight
+  explicit WatchedGraph(Graph<N, E> graph);
+
+  // Methods
+  // Starts keeping distances from src, with one full Dijkstra. Returns false if src was already
+  // watched. Throws std::out_of_range if src is not in the graph.
+  bool Watch(const N& src);
+  bool Unwatch(const N& src);
+  bool IsWatched(const N& src) const;
+  // Watched sources, in sorted order
+  std::vector<N> GetWatched() const;
+
+  // Distance from src to dst, or null if dst can't be reached. The pointer is valid until the
+  // next change. Throws std::out_of_range if src is not watched.
+  const E* Distance(const N& src, const N& dst) const;
+  // Nodes on a shortest path from src to dst, starting with src. Empty if dst can't be reached.
+  // Throws std::out_of_range if src is not watched.
+  std::vector<N> PathTo(const N& src, const N& dst) const;
+  // Every distance from src, as Dijkstra(GetGraph(), src) would report them. Ties between
+  // equally short paths may pick different predecessors.
+  // Throws std::out_of_range if src is not watched.
+  ShortestPaths<N, E> Paths(const N& src) const;
+
+  // The same changes as Graph's, which update the watched trees as they go. Deleting a watched
+  // source stops watching it, and Clear stops watching everything.
+  bool InsertNode(const N& val) { return graph_.InsertNode(val); }
+  // Throws std::domain_error if w is negative
+  bool InsertEdge(const N& src, const N& dst, const E& w);
+  bool erase(const N& src, const N& dst, const E& w);
+  bool DeleteNode(const N& val);
+  void Clear();
+
+  const Graph<N, E>& GetGraph() const { return graph_; }
+  // Nodes the last change or Watch visited, added up over the watched sources: those it
+  // settled plus those it cleared. A measure of how much work it took.
+  std::size_t LastUpdateCost() const { return last_cost_; }
+
+ private:
+  // A node's distance from the source and the node before it on its path, which is null for
+  // the source itself
+  struct Reach {
+    E distance;
+    const N* parent;
+  };
+  // Nodes reached from one source, keyed by their address in the graph
+  using Tree = std::unordered_map<const N*, Reach>;
+
+  Graph<N, E> graph_;
+  std::unordered_map<const N*, Tree> trees_;
+  std::size_t last_cost_ = 0;
+
+  const N* Find(const N& val) const;
+  const Tree& TreeOf(const N& src, const char* caller) const;
+  // Runs Dijkstra outwards from seeds, whose entries in tree are already set, updating every
+  // node it finds a shorter path to
+  void Propagate(Tree& tree, const std::vector<const N*>& seeds);
+  // Recomputes the subtrees below roots, whose tree edges have gone
+  void Repair(Tree& tree, const std::vector<const N*>& roots);
+};
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_WATCHED_GRAPH_H_
+
+#include "assignments/dg/watched_graph.tpp"
@@ -0,0 +1,288 @@
+#ifndef ASSIGNMENTS_DG_WATCHED_GRAPH_TPP_
+#define ASSIGNMENTS_DG_WATCHED_GRAPH_TPP_
+
+#include "assignments/dg/watched_graph.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_set>
+
+// Begin constructors
+template <typename N, typename E>
+gdwg::WatchedGraph<N, E>::WatchedGraph(Graph<N, E> graph) : graph_{std::move(graph)} {
+  for (auto edge : graph_.Edges()) {
+    if (std::get<2>(edge) < E{}) {
+      throw std::domain_error(
+          "Cannot construct gdwg::WatchedGraph from a graph with negative weights");
+    }
+  }
+}
+// end constructors
+
+template <typename N, typename E>
+const N* gdwg::WatchedGraph<N, E>::Find(const N& val) const {
+  auto search = graph_.Adjacency().find(val);
+  return search == graph_.Adjacency().end() ? nullptr : search->first.get();
+}
+
+template <typename N, typename E>
+const typename gdwg::WatchedGraph<N, E>::Tree&
+gdwg::WatchedGraph<N, E>::TreeOf(const N& src, const char* caller) const {
+  auto search = trees_.find(Find(src));
+  if (search == trees_.end()) {
+    throw std::out_of_range(std::string{"Cannot call gdwg::WatchedGraph::"} + caller +
+                            " if src is not watched");
+  }
+  return search->second;
+}
+
+template <typename N, typename E>
+void gdwg::WatchedGraph<N, E>::Propagate(Tree& tree, const std::vector<const N*>& seeds) {
+  const auto& adjacency = graph_.Adjacency();
+  // The heap holds positions in nodes, which gets an entry per push
+  std::vector<const N*> nodes;
+  detail::DijkstraHeap<E> heap;
+  for (auto seed : seeds) {
+    heap.Push(tree.find(seed)->second.distance, nodes.size());
+    nodes.push_back(seed);
+  }
+  while (!heap.Empty()) {
+    auto [d, id] = heap.Pop();
+    const N* u = nodes[id];
+    if (tree.find(u)->second.distance < d) {
+      continue;
+    }
+    ++last_cost_;
+    for (const auto& out : adjacency.find(*u)->second) {
+      const N* v = &std::get<0>(*out);
+      E candidate = d + std::get<1>(*out);
+      auto [reach, inserted] = tree.try_emplace(v, Reach{candidate, u});
+      if (inserted || candidate < reach->second.distance) {
+        reach->second = Reach{candidate, u};
+        heap.Push(candidate, nodes.size());
+        nodes.push_back(v);
+      }
+    }
+  }
+}
+
+template <typename N, typename E>
+void gdwg::WatchedGraph<N, E>::Repair(Tree& tree, const std::vector<const N*>& roots) {
+  const auto& adjacency = graph_.Adjacency();
+  const auto& predecessors = graph_.Predecessors();
+
+  // Everything below the roots lost its path along with them
+  std::vector<const N*> cleared;
+  std::unordered_set<const N*> below;
+  for (auto root : roots) {
+    if (below.insert(root).second) {
+      cleared.push_back(root);
+    }
+  }
+  for (std::size_t i = 0; i < cleared.size(); ++i) {
+    for (const auto& out : adjacency.find(*cleared[i])->second) {
+      const N* v = &std::get<0>(*out);
+      auto reach = tree.find(v);
+      if (reach != tree.end() && reach->second.parent == cleared[i] && below.insert(v).second) {
+        cleared.push_back(v);
+      }
+    }
+  }
+  for (auto node : cleared) {
+    tree.erase(node);
+  }
+  last_cost_ += cleared.size();
+
+  // Distances outside the subtree still hold, so the best edge in from outside it is a
+  // starting point for each cleared node. An edge set is sorted by weight within a
+  // destination, so the first edge to the node is the lightest.
+  std::vector<const N*> seeds;
+  for (auto node : cleared) {
+    auto incoming = predecessors.find(node);
+    if (incoming == predecessors.end()) {
+      continue;
+    }
+    Reach best{E{}, nullptr};
+    for (const auto& pred : incoming->second) {
+      auto from = tree.find(pred.first);
+      if (from == tree.end() || below.count(pred.first) > 0) {
+        continue;
+      }
+      const auto& edges = adjacency.find(*pred.first)->second;
+      E distance = from->second.distance + std::get<1>(**edges.lower_bound(*node));
+      if (best.parent == nullptr || distance < best.distance) {
+        best = Reach{distance, pred.first};
+      }
+    }
+    if (best.parent != nullptr) {
+      tree.emplace(node, best);
+      seeds.push_back(node);
+    }
+  }
+  Propagate(tree, seeds);
+}
+
+template <typename N, typename E>
+bool gdwg::WatchedGraph<N, E>::Watch(const N& src) {
+  const N* node = Find(src);
+  if (node == nullptr) {
+    throw std::out_of_range(
+        "Cannot call gdwg::WatchedGraph::Watch if src doesn't exist in the graph");
+  }
+  auto [tree, inserted] = trees_.try_emplace(node);
+  if (!inserted) {
+    return false;
+  }
+  last_cost_ = 0;
+  tree->second.emplace(node, Reach{E{}, nullptr});
+  Propagate(tree->second, {node});
+  return true;
+}
+
+template <typename N, typename E>
+bool gdwg::WatchedGraph<N, E>::Unwatch(const N& src) {
+  const N* node = Find(src);
+  return node != nullptr && trees_.erase(node) > 0;
+}
+
+template <typename N, typename E>
+bool gdwg::WatchedGraph<N, E>::IsWatched(const N& src) const {
+  return trees_.find(Find(src)) != trees_.end();
+}
+
+template <typename N, typename E>
+std::vector<N> gdwg::WatchedGraph<N, E>::GetWatched() const {
+  std::vector<N> watched;
+  watched.reserve(trees_.size());
+  for (const auto& tree : trees_) {
+    watched.push_back(*tree.first);
+  }
+  std::sort(watched.begin(), watched.end());
+  return watched;
+}
+
+template <typename N, typename E>
+const E* gdwg::WatchedGraph<N, E>::Distance(const N& src, const N& dst) const {
+  const auto& tree = TreeOf(src, "Distance");
+  auto reach = tree.find(Find(dst));
+  return reach == tree.end() ? nullptr : &reach->second.distance;
+}
+
+template <typename N, typename E>
+std::vector<N> gdwg::WatchedGraph<N, E>::PathTo(const N& src, const N& dst) const {
+  const auto& tree = TreeOf(src, "PathTo");
+  std::vector<N> path;
+  for (auto reach = tree.find(Find(dst)); reach != tree.end();
+       reach = tree.find(reach->second.parent)) {
+    path.push_back(*reach->first);
+    if (reach->second.parent == nullptr) {
+      break;
+    }
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+template <typename N, typename E>
+gdwg::ShortestPaths<N, E> gdwg::WatchedGraph<N, E>::Paths(const N& src) const {
+  ShortestPaths<N, E> paths;
+  for (const auto& [node, reach] : TreeOf(src, "Paths")) {
+    paths.distance.emplace(*node, reach.distance);
+    if (reach.parent != nullptr) {
+      paths.predecessor.emplace(*node, *reach.parent);
+    }
+  }
+  return paths;
+}
+
+template <typename N, typename E>
+bool gdwg::WatchedGraph<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
+  if (w < E{}) {
+    throw std::domain_error("Cannot call gdwg::WatchedGraph::InsertEdge with a negative weight");
+  }
+  last_cost_ = 0;
+  if (!graph_.InsertEdge(src, dst, w)) {
+    return false;
+  }
+  const N* from = Find(src);
+  const N* to = Find(dst);
+  for (auto& watched : trees_) {
+    auto& tree = watched.second;
+    auto reach = tree.find(from);
+    if (reach == tree.end()) {
+      continue;
+    }
+    E candidate = reach->second.distance + w;
+    auto [next, inserted] = tree.try_emplace(to, Reach{candidate, from});
+    if (inserted || candidate < next->second.distance) {
+      next->second = Reach{candidate, from};
+      Propagate(tree, {to});
+    }
+  }
+  return true;
+}
+
+template <typename N, typename E>
+bool gdwg::WatchedGraph<N, E>::erase(const N& src, const N& dst, const E& w) {
+  last_cost_ = 0;
+  const N* from = Find(src);
+  const N* to = Find(dst);
+  if (!graph_.erase(src, dst, w)) {
+    return false;
+  }
+  for (auto& watched : trees_) {
+    auto& tree = watched.second;
+    // Only the tree edge into dst matters, and a parallel edge may be the one in the tree
+    auto reach = tree.find(to);
+    if (reach != tree.end() && reach->second.parent == from &&
+        tree.find(from)->second.distance + w == reach->second.distance) {
+      Repair(tree, {to});
+    }
+  }
+  return true;
+}
+
+template <typename N, typename E>
+bool gdwg::WatchedGraph<N, E>::DeleteNode(const N& val) {
+  last_cost_ = 0;
+  auto search = graph_.Adjacency().find(val);
+  if (search == graph_.Adjacency().end()) {
+    return false;
+  }
+  const N* node = search->first.get();
+  trees_.erase(node);
+
+  // Find the node's children in each tree while its edges are still there
+  std::vector<std::pair<Tree*, std::vector<const N*>>> cut;
+  for (auto& watched : trees_) {
+    auto& tree = watched.second;
+    if (tree.erase(node) == 0) {
+      continue;
+    }
+    std::vector<const N*> roots;
+    for (const auto& out : search->second) {
+      const N* v = &std::get<0>(*out);
+      auto reach = tree.find(v);
+      if (reach != tree.end() && reach->second.parent == node) {
+        roots.push_back(v);
+      }
+    }
+    cut.emplace_back(&tree, std::move(roots));
+  }
+  graph_.DeleteNode(val);
+  for (auto& [tree, roots] : cut) {
+    Repair(*tree, roots);
+  }
+  return true;
+}
+
+template <typename N, typename E>
+void gdwg::WatchedGraph<N, E>::Clear() {
+  graph_.Clear();
+  trees_.clear();
+  last_cost_ = 0;
+}
+
+#endif